@@ -12,7 +12,7 @@
 
 class TextureAtlas;
 
-class AnimationSystem : public SystemI
+class AnimationSystem final : public SystemI
 {
 public:
     AnimationSystem(utils::ContiguousColony<AnimationComponent, int> &comps,
@@ -24,6 +24,10 @@ public:
     virtual void preUpdate(float dt, EntityRegistryT &entities) override {}
     virtual void update(float dt) override;
     virtual void postUpdate(float dt, EntityRegistryT &entities) override {}
+    virtual SystemAccess getAccess() const override
+    {
+        return SystemAccess{}.write<AnimationComponent>();
+    }
 
 private:
     Rect<int> getNextFrame(AnimationComponent &comp);
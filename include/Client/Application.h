@@ -52,6 +52,9 @@ public:
 
     void startGame(GameId game_id);
 
+    //! the simulation always advances in steps of 1/ticks_per_second (60 or 120 make sense), independent of the frame rate
+    void setSimulationRate(int ticks_per_second);
+
     friend void gameLoop(void *);
     friend void loadAssetsLoop(void *);
 
@@ -75,6 +78,12 @@ private:
     std::unordered_map<GameId, std::string> m_intro_texts;
     nlohmann::json m_text_resources;
 
-    float m_dt = 0.f; //! time step
+    float m_dt = 0.f; //! real duration of the last frame
+
+    //! simulation time which was not simulated yet, it is always less than one step after iterate()
+    float m_accumulator = 0.f;
+    float m_fixed_dt = 1.f / 60.f;
+    //! when a frame takes too long, the steps over this limit are dropped instead of slowing down the next frame even more
+    static constexpr int MAX_SUBSTEPS = 4;
     Statistics m_avg_frame_time;
 };
@@ -3,6 +3,8 @@
 #include "BVH.h"
 
 #include <vector>
+#include <array>
+#include <span>
 #include <unordered_set>
 
 #include "GameObject.h"
@@ -13,12 +15,39 @@
 #include "Renderer.h"
 
 #include "ObjectRegistry.h"
+#include "TransformStore.h"
+#include "Utils/MortonOrder.h"
 
 
+//! view of one convex polygon of a CollisionShape in world space
+struct WorldPolygon
+{
+    std::span<const utils::Vector2f> points;
+    std::span<const utils::Vector2f> normals; //! normals[i] is the outer normal of edge points[i] -> points[i+1], zero if the edge is degenerate
+    utils::Vector2f center;
+};
+
 struct CollisionShape
 {
     std::vector<Polygon> convex_shapes;
 
+    //! world-space vertices and edge normals of all convex_shapes, one after another
+    //! refreshed by the CollisionSystem once per tick for shapes whose entity moved
+    std::vector<utils::Vector2f> world_points;
+    std::vector<utils::Vector2f> world_normals;
+    std::vector<std::size_t> world_offsets; //! where each polygon starts in the buffers, one extra at the end
+
+    void updateWorldGeometry();
+    WorldPolygon getWorldPolygon(std::size_t shape_ind) const
+    {
+        assert(shape_ind + 1 < world_offsets.size());
+        auto begin = world_offsets[shape_ind];
+        auto count = world_offsets[shape_ind + 1] - begin;
+        return {std::span(world_points).subspan(begin, count),
+                std::span(world_normals).subspan(begin, count),
+                convex_shapes[shape_ind].getPosition()};
+    }
+
     AABB getBoundingRect() const
     {
         assert(convex_shapes.size() > 0);
@@ -56,6 +85,14 @@ namespace Collisions
     };
 
     using CollisionCallbackT = std::function<void(GameObject &, GameObject &, CollisionData)>;
+
+    //! when the resolver of a pair of types is called
+    enum class ContactMode
+    {
+        EveryFrame, //! every frame while the objects overlap, needed for pushing objects apart
+        OnEnter,    //! only in the frame when the objects start to overlap
+    };
+
     class CollisionSystem : public SystemI
     {
 
@@ -63,7 +100,7 @@ namespace Collisions
         std::unordered_map<ObjectType, BoundingVolumeTree> m_object_type2tree;
 
     public:
-        CollisionSystem(PostOffice &messanger, utils::ContiguousColony<CollisionComponent, int> &comps);
+        CollisionSystem(PostOffice &messanger, utils::ContiguousColony<CollisionComponent, int> &comps, TransformStore &transforms);
 
         void insertObject(GameObject &object);
         void removeObject(GameObject &object);
@@ -74,7 +111,27 @@ namespace Collisions
 
         void draw(Renderer &canvas);
 
-        void registerResolver(ObjectType type_a, ObjectType type_b, CollisionCallbackT callback = nullptr);
+        //! keeps the collision components roughly sorted along the Z-order curve of their positions,
+        //! so that the components of nearby entities (which are queried together) are also close in memory
+        void setSpatialSorting(bool enabled, std::size_t swaps_per_frame = 64, float cell_size = 50.f);
+
+        //! rects in the trees are stretched by multiplier * (displacement in one frame) along the motion of the object
+        //! so that fast objects need not be reinserted every frame, 0 turns the prediction off
+        void setDisplacementMultiplier(float multiplier);
+        //! how many objects had to be reinserted into the trees in the last update and since the start
+        std::size_t getReinsertionCount() const;
+        std::size_t getTotalReinsertionCount() const;
+
+        void registerResolver(ObjectType type_a, ObjectType type_b, CollisionCallbackT callback = nullptr,
+                              ContactMode mode = ContactMode::EveryFrame);
+
+        //! forgets the cached contacts, for when positions jump (e.g. restoring a snapshot) and not move
+        //! contacts found again afterwards are reported as new, no exit events are sent for the forgotten ones
+        void clearContacts();
+
+        //! the last manifold of two touching objects, nullptr if they do not touch
+        //! the separation axis points from the object which comes first in the registered resolver
+        const CollisionData *findContact(int id_a, int id_b) const;
 
         std::vector<int> findNearestObjectInds(ObjectType type, utils::Vector2f center, float radius) const;
         std::vector<CollisionComponent *> findNearestObjects(ObjectType type, utils::Vector2f center, float radius) const;
@@ -84,20 +141,75 @@ namespace Collisions
         utils::Vector2f findClosestIntesection(ObjectType type, utils::Vector2f at, utils::Vector2f dir, float length);
 
     private:
-        void shapesCollide(const std::vector<Polygon> &shape1, const std::vector<Polygon> &shape2,
-                           GameObject &obj1, GameObject &obj2, CollisionCallbackT &callback);
+        struct Resolver
+        {
+            CollisionCallbackT callback;
+            ContactMode mode;
+        };
+
+        //! a pair of objects which were close in the broad phase
+        struct ContactPair
+        {
+            CollisionData manifold;
+            std::uint64_t last_tick = 0; //! when the pair was last found by the broad phase
+            bool touching = false;
+            int first_id = -1; //! the manifold was computed with this object as the first one
+        };
+
+        AABB makeFatRect(AABB fitting_rect, utils::Vector2f displacement) const;
+        CollisionData shapesCollide(const CollisionShape &shape1, const CollisionShape &shape2) const;
         void narrowPhase2(const std::vector<std::pair<int, int>> &colliding_pairs,
                           EntityRegistryT &entities,
-                          CollisionCallbackT &callback);
+                          Resolver &resolver, bool same_types);
+        //! runs SAT for the pairs in m_pairs_to_compute, spread over the thread pool when there are enough of them
+        void computeManifolds(const std::vector<std::pair<int, int>> &colliding_pairs);
+        void removeStaleContacts();
+        void eraseContactsOf(int id);
+        bool wasRemovedInNarrowPhase(int id) const;
+        bool hasMoved(int entity_id) const;
 
-        CollisionData getCollisionData(const Polygon &pa, const  Polygon &pb) const;
+        CollisionData getCollisionData(const WorldPolygon &pa, const WorldPolygon &pb) const;
 
     private:
         PostOffice *p_post_office;
-        std::unordered_map<std::pair<int, int>, CollisionCallbackT, pair_hash> m_registered_resolvers;
-        std::unordered_set<std::pair<int, int>, pair_hash> m_collided2;
+        std::unordered_map<std::pair<int, int>, Resolver, pair_hash> m_registered_resolvers;
+
+        //! persists between ticks, so that pairs which did not move skip the narrow phase
+        //! and enter/exit events can be sent; pairs of objects of the same type are keyed with the smaller id first
+        std::unordered_map<std::pair<int, int>, ContactPair, pair_hash> m_contacts;
+        std::uint64_t m_tick = 0;
+        std::vector<bool> m_moved; //! by entity id, which entities got a new shape in this tick
+
+        //! narrow phase of one resolver, indexed like the pairs of the broad phase
+        struct PairContact
+        {
+            ContactPair *p_contact;
+            bool was_touching;
+        };
+        std::vector<PairContact> m_pair_contacts;
+        std::vector<std::size_t> m_pairs_to_compute; //! pairs whose manifold is recomputed in this tick
+        bool m_in_narrow_phase = false;              //! set while resolvers are called
+        std::vector<int> m_removed_in_narrow_phase; //! objects removed by resolvers, their pairs are skipped
+        static constexpr std::size_t NARROW_PHASE_GRAIN = 32;
+#ifndef NDEBUG
+        std::unordered_set<std::pair<int, int>, pair_hash> m_collided2; //! to check that each pair is evaluated once
+#endif
 
         utils::ContiguousColony<CollisionComponent, int> &m_components;
+        TransformStore &m_transforms;
+
+        static constexpr float FAT_RECT_SCALE = 1.5f;
+        float m_displacement_multiplier = 4.f;
+        float m_last_dt = 1.f / 60.f; //! objects inserted between updates are predicted with this
+        std::size_t m_reinsertion_count = 0;
+        std::size_t m_total_reinsertion_count = 0;
+
+        bool m_spatial_sorting = false;
+        float m_sorting_cell_size = 50.f;
+        utils::IncrementalSorter m_sorter;
+
+        std::uint64_t m_seen_components_version = 0;
+        std::uint64_t m_seen_transforms_version = 0;
     };
 
     struct Edge
@@ -121,13 +233,29 @@ namespace Collisions
         Edge edge;
     };
 
-    CollisionData inline calcCollisionData(const std::vector<utils::Vector2f> &points1,
-                                           const std::vector<utils::Vector2f> &points2);
-    int inline furthestVertex(utils::Vector2f separation_axis, const std::vector<utils::Vector2f> &points);
-    CollisionFeature inline obtainFeatures(const utils::Vector2f axis, const std::vector<utils::Vector2f> &points);
-    std::vector<utils::Vector2f> inline clip(utils::Vector2f v1, utils::Vector2f v2, utils::Vector2f n, float overlap);
+    //! at most two points are left after clipping an edge
+    struct ClippedPoints
+    {
+        std::array<utils::Vector2f, 2> points;
+        int count = 0;
+
+        void push(utils::Vector2f point)
+        {
+            assert(count < 2);
+            points[count++] = point;
+        }
+    };
+
+    void computeEdgeNormals(std::span<const utils::Vector2f> points, std::span<utils::Vector2f> normals);
+
+    //! separating axis test of two convex polygons with precomputed unit edge normals (zero for degenerate edges)
+    CollisionData calcCollisionData(std::span<const utils::Vector2f> points1, std::span<const utils::Vector2f> normals1,
+                                    std::span<const utils::Vector2f> points2, std::span<const utils::Vector2f> normals2);
+    int inline furthestVertex(utils::Vector2f separation_axis, std::span<const utils::Vector2f> points);
+    CollisionFeature inline obtainFeatures(const utils::Vector2f axis, std::span<const utils::Vector2f> points);
+    ClippedPoints inline clip(utils::Vector2f v1, utils::Vector2f v2, utils::Vector2f n, float overlap);
 
-    std::vector<utils::Vector2f> inline clipEdges(
+    ClippedPoints inline clipEdges(
         CollisionFeature &ref_features,
         CollisionFeature &inc_features,
         utils::Vector2f n);
@@ -3,27 +3,58 @@
 #include <unordered_map>
 #include <memory>
 #include <typeindex>
+#include <string>
+#include <vector>
 
 #include "Utils/ContiguousColony.h"
+#include "Utils/ColonyView.h"
+#include "Utils/BinaryStream.h"
 #include "Vector2.h"
 
 #include "Systems/System.h"
+#include "Systems/SystemScheduler.h"
+#include "TransformStore.h"
 #include "CollisionSystem.h"
 #include "Components.h"
 
 
+struct ComponentMemoryInfo
+{
+    std::string type_name;
+    std::size_t count;
+    std::size_t bytes_used;
+    std::size_t bytes_reserved;
+};
+
 template <class... ComponentTypes>
 class ComponentWorld
 {
 public:
-    ComponentWorld(EntityRegistryT &entity_registry)
-        : m_entity_registry(entity_registry)
+    ComponentWorld(EntityRegistryT &entity_registry, TransformStore &transforms)
+        : m_entity_registry(entity_registry), m_transforms(transforms)
+    {
+    }
+
+    TransformStore &getTransforms()
     {
+        return m_transforms;
     }
 
     void registerSystem(std::shared_ptr<SystemI> p_system)
     {
-        m_systems2[typeid(*p_system)] = p_system;
+        m_scheduler.add(p_system);
+    }
+
+    //! systems which do not conflict run in parallel on the pool, nullptr runs them serially
+    void setThreadPool(utils::ThreadPool *pool)
+    {
+        p_pool = pool;
+        m_scheduler.setThreadPool(pool);
+    }
+
+    utils::ThreadPool *getThreadPool() const
+    {
+        return p_pool;
     }
 
     template <class ComponentType>
@@ -70,6 +101,12 @@ public:
         // m_ecs.removeComponent<ComponentType>(entity_id);
         std::get<ComponentHolder<ComponentType>>(m_components).eraseDelayed(entity_id);
     }
+    //! removes all components of the entity in postUpdate
+    void removeEntityDelayed(int entity_id)
+    {
+        std::apply([entity_id](auto &&...comp_holder)
+                   { (comp_holder.eraseDelayed(entity_id), ...); }, m_components);
+    }
     void removeEntity(int entity_id)
     {
         // m_ecs.removeEntity(entity_id);        
@@ -83,6 +120,55 @@ public:
         return std::get<ComponentHolder<ComponentType>>(m_components).getComponents();
     }
 
+    template <class ComponentType>
+    void reserve(std::size_t capacity)
+    {
+        getComponents<ComponentType>().reserve(capacity);
+    }
+
+    //! gives back memory of all colonies which is not used, call when changing levels
+    void shrink_to_fit()
+    {
+        std::apply([](auto &&...comp_holder)
+                   { (comp_holder.shrink_to_fit(), ...); }, m_components);
+    }
+
+    //! memory taken by the colony of each component type
+    std::vector<ComponentMemoryInfo> memoryReport()
+    {
+        std::vector<ComponentMemoryInfo> report;
+        (report.push_back({typeid(ComponentTypes).name(),
+                           getComponents<ComponentTypes>().size(),
+                           getComponents<ComponentTypes>().bytesUsed(),
+                           getComponents<ComponentTypes>().bytesReserved()}), ...);
+        return report;
+    }
+
+    //! components which cannot be written into a binary blob are copied into here instead
+    using ComponentCopies = std::tuple<std::pair<std::vector<int>, std::vector<ComponentTypes>>...>;
+
+    //! writes all colonies into the writer (or copies) so that they can be restored by readSnapshot
+    //! should be called between frames, changes waiting for postUpdate are not part of the snapshot
+    void writeSnapshot(utils::BinaryWriter &writer, ComponentCopies &copies)
+    {
+        (writeColony<ComponentTypes>(writer, std::get<std::pair<std::vector<int>, std::vector<ComponentTypes>>>(copies)), ...);
+    }
+
+    //! changes recorded but not yet applied belong to the state being replaced, so they are dropped
+    void readSnapshot(utils::BinaryReader &reader, const ComponentCopies &copies)
+    {
+        std::apply([](auto &&...comp_holder)
+                   { (comp_holder.clearWaiting(), ...); }, m_components);
+        (readColony<ComponentTypes>(reader, std::get<std::pair<std::vector<int>, std::vector<ComponentTypes>>>(copies)), ...);
+    }
+
+    //! iterates entities having all of the Components, yields tuples (entity_id, Components&...)
+    template <class... Components>
+    utils::ColonyView<int, Components...> view()
+    {
+        return utils::ColonyView<int, Components...>(getComponents<Components>()...);
+    }
+
     template <class... Components>
     void addEntity(int id, Components&&... comps)
     {
@@ -91,35 +177,66 @@ public:
 
     void preUpdate(float dt)
     {
-        for (auto &[system_id, system] : m_systems2)
-        {
-            system->preUpdate(dt, m_entity_registry);
-        }
+        m_scheduler.preUpdate(dt, m_entity_registry);
     }
     void update(float dt)
     {
-        for (auto &[system_id, system] : m_systems2)
-        {
-            system->update(dt);
-        }
+        m_scheduler.update(dt);
     }
 
     void postUpdate(float dt)
     {
-        for (auto &[system_id, system] : m_systems2)
+        m_scheduler.postUpdate(dt, m_entity_registry);
+
+        //! apply structural changes recorded during the update steps, one component type at a time
+        std::apply(([](auto&&... comps){(comps.applyWaiting(),...);}), m_components);
+    }
+
+    void draw()
+    {
+        m_scheduler.draw();
+    }
+
+private:
+    template <class ComponentType>
+    void writeColony(utils::BinaryWriter &writer, std::pair<std::vector<int>, std::vector<ComponentType>> &copy)
+    {
+        auto &colony = getComponents<ComponentType>();
+        if constexpr (utils::isBinarySerializable<ComponentType>())
+        {
+            utils::writeBinary(writer, colony.data_ind2id);
+            utils::writeBinary(writer, colony.data);
+        }
+        else
         {
-            system->postUpdate(dt, m_entity_registry);
+            copy.first = colony.data_ind2id;
+            copy.second = colony.data;
         }
+    }
 
-        //! add components to their holders at the end of update steps
-        std::apply(([](auto&&... comps){(comps.addWaiting(),...);}), m_components);
-        std::apply(([](auto&&... comps){(comps.removeWaiting(),...);}), m_components);
+    template <class ComponentType>
+    void readColony(utils::BinaryReader &reader, const std::pair<std::vector<int>, std::vector<ComponentType>> &copy)
+    {
+        auto &colony = getComponents<ComponentType>();
+        if constexpr (utils::isBinarySerializable<ComponentType>())
+        {
+            utils::readBinary(reader, colony.data_ind2id);
+            utils::readBinary(reader, colony.data);
+        }
+        else
+        {
+            colony.data_ind2id = copy.first;
+            colony.data = copy.second;
+        }
+        colony.rebuildIndex();
     }
 
 private:
     EntityRegistryT &m_entity_registry;
+    TransformStore &m_transforms;
 
-    std::unordered_map<std::type_index, std::shared_ptr<SystemI>> m_systems2;
+    utils::ThreadPool *p_pool = nullptr;
+    SystemScheduler m_scheduler;
     std::tuple<ComponentHolder<ComponentTypes>...> m_components;
 };
 
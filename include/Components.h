@@ -32,6 +32,7 @@ struct HealthComponent
     float hp = max_hp;
     float hp_regen;
 };
+BOOST_DESCRIBE_STRUCT(HealthComponent, (), (max_hp, hp, hp_regen));
 
 struct TimedEventComponent
 {
@@ -77,6 +78,7 @@ struct AnimationComponent
     Rect<int> tex_rect = {0, 0, 0, 0};
     utils::Vector2i texture_size = {1, 1};
 };
+BOOST_DESCRIBE_STRUCT(AnimationComponent, (), (id, texture_id, time, cycle_duration, current_frame_id, n_repeats_left, tex_rect, texture_size));
 
 struct SpriteComponent
 {
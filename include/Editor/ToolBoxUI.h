@@ -31,6 +31,7 @@ public:
        bool handleEvent(SDL_Event event);
 
        void drawResourceManager();
+       void drawMemoryStats();
        void drawSoundOverview();
        void drawTextureOverview();
        void drawFileSelection(std::string &selected_file_name,
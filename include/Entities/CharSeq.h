@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include "../GameObject.h"
 
 class Font;
@@ -19,6 +21,7 @@ public:
 public:
     CharSeq(GameWorld &world, const Spec &spec, int ent_id = -1);
     virtual void onCreation() override;
+    virtual void update(float dt) override;
     virtual void draw(LayersHolder &target, Assets& assets) override;
     virtual void onCollisionWith(GameObject &obj, CollisionData &c_data) override;
 
@@ -26,5 +29,6 @@ private:
     float m_lifetime = 10.f;
     Font* m_font = nullptr;
     std::string m_sequence;
+    std::optional<utils::Vector2f> m_pending_size; //! measured when drawing, applied in the next update
 };
 BOOST_DESCRIBE_STRUCT(CharSeq::Spec, (GameObjectSpec), (life_time));
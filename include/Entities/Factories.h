@@ -31,8 +31,6 @@
 
 //! THESE MACROS Create a enum with all registered Types and connects it to types themselves!!
 /*------------------- */
-template <typename T>
-constexpr TypeId getTypeId();
 #define MAKE_ID(type) \
     template <>       \
     constexpr TypeId getTypeId<type>() { return TypeId::type; }
@@ -40,29 +38,13 @@ OBJ_LIST(MAKE_ID)
 #undef MAKE_ID
 /*------------------- */
 
-template <class EntityType>
-struct Deleter
-{
-
-    Deleter(ObjectArena& arena) : arena(arena){}
-
-    void operator()(EntityType *p_obj) 
-    {
-        std::destroy_at(p_obj);
-        int type_id = static_cast<int>(getTypeId<EntityType>());
-        arena.deallocateObject(type_id, (void *)p_obj);
-    }
-    ObjectArena& arena;
-};
-
+//! the object and its shared_ptr control block live in one slot of the world's arena,
+//! so spawning many objects of one type does not call malloc once the type's chunks are warm
 template <class EntityType, typename Spec=EntityType::Spec>
 std::shared_ptr<EntityType> makeObject(GameWorld& world, Spec&& spec, int ent_id)  
 {
-    
-    return std::make_shared<EntityType>(world,std::forward<Spec>(spec), ent_id);
-    // void *location = world.allocateObject(static_cast<int>(getTypeId<EntityType>()));
-    // auto *p_obj = std::construct_at(static_cast<EntityType *>(location), world,  std::forward<Spec>(spec), ent_id);
-    // return std::shared_ptr<EntityType>(p_obj, Deleter<EntityType>(world.getArena()));
+    ArenaAllocator<EntityType> allocator(world.getArena(), static_cast<int>(getTypeId<EntityType>()));
+    return std::allocate_shared<EntityType>(allocator, world, std::forward<Spec>(spec), ent_id);
 }
 
 
@@ -102,7 +84,7 @@ public:
 public:
     EntityFactory2(GameWorld &world) : m_world(world)
     {
-        world.registerObject(static_cast<int>(getTypeId<EntityType>()), sizeof(EntityType));
+        //! the arena registers the type on first allocation, when the size of the control block is known
     }
 
 private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameObject.h"
+#include "Polygon.h"
 #include "Vertex.h"
 
 class Meteor : public GameObject
@@ -45,3 +46,6 @@ private:
     std::vector<Vertex> m_verts;
 
 };
+
+//! convex polygon with n vertices inside of [-1, 1]^2, the shape of meteors
+Polygon generateRandomConvexPolygon(int n);
@@ -37,6 +37,10 @@ enum class TypeId
     Count
 };
 using ObjectType = TypeId;
+
+//! specialized for every registered type in Factories.h
+template <typename T>
+constexpr TypeId getTypeId();
 /*------------------- */
 #include "describe.hpp"
 BOOST_DESCRIBE_ENUM(TypeId, TYPE_LIST)
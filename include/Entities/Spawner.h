@@ -13,6 +13,7 @@ public:
         float delay = 0.f;
         float period = 3.f;
         int spawn_count = -1;
+        int max_alive = -1; //! no spawning while the world has this many text bubbles, -1 for no limit
         TypeId  spawned_type;
         TextBubble::Spec spawned_spec;
     };
@@ -26,6 +27,7 @@ private:
     float m_period;
     float m_delay;
     int m_spawn_count = -1;
+    int m_max_alive = -1;
     TextBubble::Spec m_spawnee;
 };
-BOOST_DESCRIBE_STRUCT(Spawner::Spec, (GameObjectSpec), (period, spawned_spec, spawn_count));
+BOOST_DESCRIBE_STRUCT(Spawner::Spec, (GameObjectSpec), (period, spawned_spec, spawn_count, max_alive));
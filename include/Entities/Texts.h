@@ -3,6 +3,7 @@
 #include "GameObject.h"
 #include "Components.h"
 #include <Text.h>
+#include <optional>
 #include "EffectsFactory.h"
 #include "TimedEventManager.h"
 
@@ -58,6 +59,8 @@ public:
     RectangleSimple light_rect;
     TimedEventManager m_timers;
 protected:
+    virtual bool canSleep() override;
+
     bool m_has_image = false;
     bool m_is_correct = false;
     std::string m_correct_form = "Testing";
@@ -65,6 +68,7 @@ protected:
     std::string m_translation = "Penis";
     Sprite m_word_image;
     Font *m_font = nullptr;
+    std::optional<utils::Vector2f> m_pending_size; //! measured when drawing, applied in the next update
 
     ColorByte m_bottom_color;
     ColorByte m_top_color;
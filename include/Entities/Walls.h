@@ -29,6 +29,9 @@ public:
     virtual void draw(LayersHolder &target, Assets& assets) override;
     virtual void onCollisionWith(GameObject &obj, CollisionData &c_data) override;
 
+protected:
+    virtual bool canSleep() override;
+
 private:
     Color m_line_color = {0.f, 7.f, 0.f, 1.f};
     SpriteSpec m_sprite_spec;
@@ -57,6 +60,10 @@ public:
 
     void setPath(const Path &path, float speed);
 
+protected:
+    //! only walls without a path can rest
+    virtual bool canSleep() override;
+
 private:
     void moveToNextPoint();
 
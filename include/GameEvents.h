@@ -4,6 +4,7 @@
 
 #include "Vector2.h"
 #include "GameObject.h"
+#include "Utils/ContiguousColony.h"
 
 enum class GameStage
 {
@@ -27,6 +28,7 @@ struct EntityDiedEvent
     ObjectType type;
     int id;
     utils::Vector2f where;
+    utils::Handle handle; //! becomes stale once the entity is removed
 };
 
 struct EntityLeftViewEvent
@@ -40,6 +42,7 @@ struct EntityCreatedEvent
     // EntityType type;
     int id;
     utils::Vector2f where;
+    utils::Handle handle;
 };
 template <class EntityType>
 struct NewEntity
@@ -97,6 +100,18 @@ struct CollisionEventTypeEntity
     ObjectType type_b;
 };
 
+//! sent once when two objects start touching and once when they stop
+struct CollisionEnterEvent
+{
+    int id_a;
+    int id_b;
+};
+struct CollisionExitEvent
+{
+    int id_a;
+    int id_b;
+};
+
 struct DamageReceivedEvent
 {
     ObjectType cause_type;
@@ -7,6 +7,7 @@
 #include "GameObjectSpec.h"
 
 class GameWorld;
+class TransformStore;
 class TextureHolder;
 class LayersHolder;
 struct Assets;
@@ -42,6 +43,11 @@ struct Transform2D
 class GameObject
 {
 
+protected:
+    //! backing storage of the transform for objects living outside of a GameWorld
+    Transform2D m_transform;
+    TransformStore *p_transforms = nullptr;
+
 public:
     GameObject(GameWorld *world, const GameObjectSpec& spec, int id, ObjectType type);
     GameObject(GameWorld *world, int id, ObjectType type);
@@ -58,6 +64,26 @@ public:
     bool isDead() const;
 
     void updateAll(float dt);
+    //! the same without the virtual call, EntityType has to be the exact type of the object
+    template <class EntityType>
+    void updateAllAs(float dt)
+    {
+        auto old_state = beforeUpdate();
+        static_cast<EntityType *>(this)->EntityType::update(dt);
+        afterUpdate(old_state);
+    }
+
+    //! static objects never run update, they can still be moved from outside
+    void setStatic(bool is_static);
+    bool isStatic() const;
+    //! objects which allow it (see canSleep) fall asleep after they did not move for SLEEP_AFTER_TICKS updates,
+    //! a collision, a change of the transform or wake() brings them back
+    bool isSleeping() const;
+    void wake();
+    //! false for static and sleeping objects
+    bool isAwake() const;
+
+    static constexpr int SLEEP_AFTER_TICKS = 30;
 
     const utils::Vector2f getPosition() const;
     void setPosition(utils::Vector2f new_position);
@@ -71,10 +97,13 @@ public:
 
     void setSize(utils::Vector2f size);
     const utils::Vector2f &getSize() const;
+    //! needed only when m_pos/m_angle/m_size are written directly outside of update()
+    void markTransformChanged();
 
     void setDestructionCallback(std::function<void(int, ObjectType)> callback);
     
     bool isRoot() const;
+    void setParent(GameObject *parent);
     void addChild(GameObject *child);
     void removeChild(GameObject *child);
     bool isParentOf(GameObject *child) const;
@@ -90,23 +119,38 @@ public:
     GameObject *m_parent = nullptr;
 
     std::unordered_map<ObjectType, std::function<void(GameObject &, CollisionData &)>> m_collision_resolvers;
-    utils::Vector2f m_pivot = {0.f, 0.f};
+    utils::Vector2f &m_pivot;
 
 protected:
     int m_id;
 
-    //! transform data
-    Transform2D m_transform;
-
-    utils::Vector2f m_pos;
-    float m_angle = 0;
-    utils::Vector2f m_size = {1, 1};
+    //! transform data, references into the TransformStore of the world (or into m_transform)
+    utils::Vector2f &m_pos;
+    float &m_angle;
+    utils::Vector2f &m_size;
 
     GameWorld *m_world;
 
     bool m_is_dead = false;
 
+    //! true if update does nothing but integrating velocity (or has nothing to do right now), so the object may sleep
+    virtual bool canSleep();
+
+private:
+    struct UpdateState
+    {
+        utils::Vector2f pos;
+        float angle;
+        utils::Vector2f size;
+    };
+    UpdateState beforeUpdate();
+    void afterUpdate(const UpdateState &old_state);
+
 private:
+    bool m_is_static = false;
+    bool m_is_sleeping = false;
+    int m_idle_ticks = 0;
+
     std::function<void(int, ObjectType)> m_on_destruction_callback = [](int, ObjectType) {};
 
     ObjectType m_type;
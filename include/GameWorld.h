@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Utils/ObjectPool.h"
+#include "Utils/ThreadPool.h"
 
 #include <functional>
+#include <array>
+#include <typeinfo>
+#include <cassert>
 #include <unordered_map>
 #include <queue>
 
@@ -13,11 +17,21 @@
 
 #include "PostOffice.h"
 #include "ObjectArena.h"
+#include "TransformStore.h"
+#include "SceneHierarchy.h"
 
 class ToolBoxUI;
 struct Assets;
 struct Player;
 
+//! state of all components and entity transforms at some moment
+//! components which can be written as bytes go into the blob, the rest is copied into copies
+struct WorldSnapshot
+{
+    std::vector<std::byte> blob;
+    GameSystems::ComponentCopies copies;
+};
+
 class GameWorld
 {
 
@@ -26,7 +40,18 @@ public:
 
     Collisions::CollisionSystem &getCollisionSystem();
     EntityRegistryT &getEntities();
+    TransformStore &getTransforms();
     GameObject *get(int entity_id);
+    //! returns nullptr if the entity the handle points to was already destroyed
+    GameObject *get(EntityHandle handle);
+    //! an invalid handle (isAlive is false for it) if the id is neither of a live entity nor of one waiting to be added
+    EntityHandle getHandle(int entity_id) const;
+    bool isAlive(EntityHandle handle) const;
+
+    //! the snapshot is reused so taking one every frame (e.g. for rollback) does not allocate
+    void saveSnapshot(WorldSnapshot &snapshot);
+    //! restores components and transforms, the entities should be the same as when the snapshot was taken
+    void restoreSnapshot(const WorldSnapshot &snapshot);
 
     //! checks whether components that exist have existing entities
     void checkComponentsConsistency();
@@ -35,24 +60,84 @@ public:
     std::shared_ptr<GameObject> insertObject(std::function<std::shared_ptr<GameObject>(int)> obj_maker);
 
     void destroyObject(int entity_id);
+    //! releases memory the component colonies do not use once the removals of the current frame are done,
+    //! for when many entities die at once (e.g. a level is torn down)
+    void shrinkAfterRemovals();
     GameObject &addObject3(ObjectType type);
-    std::size_t getNActiveEntities(ObjectType type);
+    //! counts only entities already added to the world
+    std::size_t getNActiveEntities(ObjectType type) const;
+
+    //! calls fn(GameObject&) for all entities of the type, creating or destroying entities inside fn is fine
+    //! because both take effect only at the end of the frame
+    template <class Fn>
+    void forEachOfType(ObjectType type, Fn &&fn)
+    {
+        for (auto p_object : m_type2entities[static_cast<std::size_t>(type)])
+        {
+            fn(*p_object);
+        }
+    }
+
+    //! the same with fn(EntityType&), the getTypeId specialization from Factories.h must be visible
+    //! objects of other classes using the same type id (e.g. plain GameObjects from addObject3) are skipped
+    template <class EntityType, class Fn>
+    void forEachOfType(Fn &&fn)
+    {
+        const auto type_ind = static_cast<std::size_t>(getTypeId<EntityType>());
+        assert(m_exact_types[type_ind] && *m_exact_types[type_ind] == typeid(EntityType));
+        for (auto p_object : m_type2entities[type_ind])
+        {
+            if (m_id2exact_type[p_object->getId()])
+            {
+                fn(static_cast<EntityType &>(*p_object));
+            }
+        }
+    }
+
+    enum class UpdateMode
+    {
+        HierarchyOrder, //! every entity in the parents first sweep
+        TypeBatched,    //! entities outside of hierarchies grouped by type and updated without virtual calls first
+    };
+    void setUpdateMode(UpdateMode mode);
 
     void update(float dt);
-    void draw(LayersHolder &layers, Assets &assets, Renderer &window, const View &camera_view);
+    //! interpolation blends transforms of the previous (0) and the last (1) update, for frames drawn between fixed steps
+    void draw(LayersHolder &layers, Assets &assets, Renderer &window, const View &camera_view, float interpolation = 1.f);
 
     void removeParent(GameObject &child);
+    //! called by GameObject::setParent, the hierarchy is updated at the end of the frame
+    void onParentChanged(GameObject &child);
 
-    ObjectArena &getArena() const;
-    void registerObject(int type_id, std::size_t size);
+    ObjectArena &getArena();
+    const ObjectArena &getArena() const;
+    void registerObject(int type_id, std::size_t size, std::size_t alignment = alignof(std::max_align_t));
     void *allocateObject(int type_id);
     void deallocateObject(int type_id, void *obj_p);
 
 private:
     void addQueuedEntities();
     void removeQueuedEntities();
+    void applyParentChanges();
+    void refreshDrawRects();
+    void refreshDrawRect(GameObject &object);
+    void addToTypeList(GameObject &object);
+    void removeFromTypeList(GameObject &object);
+
+    template <class... EntityTypes>
+    void registerExactTypes();
+    template <class... EntityTypes>
+    void updateTypeBatches(float dt);
+    template <class EntityType>
+    void updateTypeBatch(float dt);
+
+private:
+    //! entities created by factories live here, it is declared first so that it is destroyed after
+    //! everything holding the entities (e.g. weak_ptrs of the collision system keep control blocks around)
+    ObjectArena m_arena;
 
 public:
+    utils::ThreadPool m_thread_pool;
     GameSystems m_systems;
     Player *m_player;
 
@@ -60,9 +145,28 @@ public:
     PostOffice *p_messenger = nullptr;
 
 private:
+    TransformStore m_transforms;
     EntityRegistryT m_entities;
 
-    utils::DynamicObjectPool2<int> m_root_entities;
+    //! rects of all entities (as used for culling), inflated so that small moves do not touch the tree
+    BoundingVolumeTree m_draw_tree;
+
+    SceneHierarchy m_hierarchy;
+    std::vector<EntityHandle> m_reparented;
+    std::vector<GameObject *> m_removed_buffer;
+    std::vector<int> m_visible_entities;
+
+    //! dense lists of added entities of each type, an entity removed from the middle is replaced by the last one
+    std::array<std::vector<GameObject *>, static_cast<std::size_t>(TypeId::Count)> m_type2entities;
+    std::vector<int> m_id2type_pos; //! position of the entity in the list of its type
+
+    UpdateMode m_update_mode = UpdateMode::HierarchyOrder;
+    //! the class registered for each type id, objects of other classes (e.g. plain GameObjects with that id) are not batched
+    std::array<const std::type_info *, static_cast<std::size_t>(TypeId::Count)> m_exact_types = {};
+    std::vector<bool> m_id2exact_type;
+    std::vector<std::uint64_t> m_id2update_tick; //! so that nobody is updated twice when the hierarchy changes mid frame
+    std::uint64_t m_tick = 0;
+    bool m_shrink_after_removals = false;
 
     std::deque<std::shared_ptr<GameObject>> m_to_add;
     std::deque<std::shared_ptr<GameObject>> m_to_destroy;
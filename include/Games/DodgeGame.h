@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Game.h"
+#include "LevelStreamer.h"
 
 struct Assets;
 
@@ -11,7 +12,7 @@ public:
     DodgeGame(Renderer &window, KeyBindings &bindings, Assets &asset);
     virtual ~DodgeGame() override {}
 
-    // virtual void updateImpl(const float dt, Renderer &win);
+    virtual void updateImpl(const float dt) override;
     // virtual void handleEventImpl(const SDL_Event &event);
     virtual void drawImpl(Renderer &window) override;
 
@@ -25,6 +26,7 @@ public:
     std::unique_ptr<PostBox<NewEntity<TextBubble>>> m_on_text_create;
     std::unique_ptr<PostBox<WordGuessedEvent>> m_guess_listener;
     std::deque<std::shared_ptr<GameLevelA>> m_levels;
+    std::unique_ptr<LevelStreamer> m_level_streamer; //! walls of the cave come and go with the camera
     
   
     std::size_t m_correct_count = 0;
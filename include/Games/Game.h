@@ -43,6 +43,7 @@ public:
     virtual void update(float dt) final;
     virtual void handleEvent(const SDL_Event &event) final;
     virtual void draw(Renderer &window) final;
+    virtual void setRenderInterpolation(float alpha) final;
     
     virtual void handleEventImpl(const SDL_Event& event);
     virtual void updateImpl(const float dt){}
@@ -106,5 +107,8 @@ public:
     bool m_move_by_tilting = false;
     std::unordered_map<std::string, std::shared_ptr<UIButtonI>> m_buttons;
 
+    utils::Vector2f m_prev_camera_center; //! the camera moves in steps as well, so it is blended like the entities
+    float m_render_alpha = 1.f;
+
     std::string m_studied_language = "de";
 };
@@ -11,5 +11,7 @@ public:
     virtual void update(float dt) = 0;
     virtual void handleEvent(const SDL_Event &event) = 0;
     virtual void draw(Renderer &window) = 0;
+    //! where between the last two updates the next draw is, 1 means exactly at the last one
+    virtual void setRenderInterpolation(float alpha) {}
     virtual ~Screen() {};
 };
@@ -21,6 +21,11 @@ struct CaveSpec2 : public GameObjectSpec
     std::vector<std::shared_ptr<GameObjectSpec>> objects;
 };
 
+//! everything except of the objects
+CaveSpec2 readCaveHeader(const nlohmann::json &lvl_data);
+//! returns nullptr for objects of unknown types
+std::shared_ptr<GameObjectSpec> readObjectSpec(const nlohmann::json &spec_json);
+
 std::unordered_map<std::string, CaveSpec2> readCaveSpecs3(const std::filesystem::path &json_file_path);
 std::vector<CaveSpec2> readCaveSpecs2(const std::filesystem::path &json_file_path);
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+#include <View.h>
+
+#include "LevelLoading.h"
+
+class GameWorld;
+
+//! Brings objects of one level into a GameWorld only around the camera.
+//! The level is split into square chunks by the positions of its objects, a chunk is parsed on a background thread
+//! when the camera gets close, its objects are created on the main thread (a few per frame) and destroyed again
+//! when the camera goes far away. Objects which were destroyed by the game while their chunk was loaded do not come back.
+class LevelStreamer
+{
+public:
+    LevelStreamer(GameWorld &world, float chunk_size = 1000.f);
+    ~LevelStreamer();
+
+    LevelStreamer(const LevelStreamer &) = delete;
+    LevelStreamer &operator=(const LevelStreamer &) = delete;
+
+    //! reads the file on a background thread, objects of a previously opened level are destroyed
+    void open(const std::filesystem::path &json_file_path, const std::string &level_key);
+    //! the level without its objects, nullptr until the file is read
+    const CaveSpec2 *getLevelInfo() const;
+    //! blocks until the file is read
+    const CaveSpec2 &waitForLevel();
+
+    //! should be called once per frame after GameWorld::update
+    void update(const View &camera_view);
+
+    //! chunks closer than load_margin to the view are loaded, those further than unload_margin are unloaded
+    void setMargins(float load_margin, float unload_margin);
+    void setMaxCreatedPerFrame(std::size_t max_count);
+
+    std::size_t getLoadedChunkCount() const;
+
+private:
+    struct Chunk;
+    struct ParsedLevel;
+
+    void takeParsedLevel();
+    void unloadAll();
+    void startLoading(Chunk &chunk);
+    //! returns the remaining creation budget
+    std::size_t advance(Chunk &chunk, std::size_t budget);
+    void unload(Chunk &chunk);
+
+    int chunkCoord(float x) const;
+
+private:
+    GameWorld &m_world;
+    float m_chunk_size;
+    float m_load_margin = 200.f;
+    float m_unload_margin = 800.f;
+    std::size_t m_max_created_per_frame = 50;
+
+    std::future<std::unique_ptr<ParsedLevel>> m_opening;
+    std::unique_ptr<CaveSpec2> m_info;
+
+    std::unordered_map<std::int64_t, std::unique_ptr<Chunk>> m_chunks; //! only chunks with some objects
+    std::vector<Chunk *> m_active_chunks; //! chunks which are not unloaded
+};
@@ -1,86 +1,137 @@
 #pragma once
 
 #include <vector>
-#include <array>
-#include <unordered_map>
-#include <list>
 #include <memory>
+#include <new>
 #include <cstddef>
 #include <cassert>
-// #include <iostream>
 
 constexpr std::size_t CHUNK_SIZE = 1 << 14;
+
+//! slab allocator for objects of registered types
+//! every type gets its own chunks and free lists, the chunks are aligned to their size
+//! so the chunk owning a slot is found just by masking the pointer
+//! a chunk which becomes empty is given back to the system (one spare chunk per type is kept for bursts)
 class ObjectArena
 {
 public:
-    ObjectArena()
+    struct Stats
     {
-        m_chunk_list.emplace_back(); // CHUNK_SIZE);
-    }
+        std::size_t slot_size = 0;
+        std::size_t live_count = 0;
+        std::size_t peak_live_count = 0;
+        std::size_t allocation_count = 0;
+        std::size_t deallocation_count = 0;
+        std::size_t chunk_count = 0;
+        std::size_t chunks_allocated = 0; //! over the whole lifetime
+        std::size_t chunks_released = 0;
+        std::size_t bytes_reserved = 0;
+    };
+
+    ObjectArena() = default;
+    ~ObjectArena();
+
+    ObjectArena(const ObjectArena &) = delete;
+    ObjectArena &operator=(const ObjectArena &) = delete;
+
+    //! returns false if the type is already registered with different size or alignment
+    bool registerObject(int type_id, std::size_t obj_size, std::size_t alignment = alignof(std::max_align_t));
+    bool isRegistered(int type_id) const;
 
-    void registerObject(int type_id, std::size_t obj_size)
+    //! the memory is suitably aligned for the registered alignment, returns nullptr for unregistered types
+    void *allocateObject(int type_id);
+    void deallocateObject(int type_id, void *obj);
+
+    Stats getStats(int type_id) const;
+
+private:
+    struct FreeSlot
     {
-        if (m_obj_sizes.count(type_id) > 0 && m_obj_sizes.at(type_id) != obj_size)
-        {
-            // std::cout << "WARNING OBJECT ALREADY REGISTERED AND HAS DIFFERENT SIZE!" << std::endl;
-            return;
-        }
-        m_obj_sizes[type_id] = obj_size;
-        m_freelists[type_id] = nullptr;
-    }
+        FreeSlot *next;
+    };
+
+    struct TypePool;
+
+    struct ChunkHeader
+    {
+        TypePool *pool;
+        std::size_t used_count = 0;
+        std::size_t bumped_count = 0; //! slots which were ever handed out
+        FreeSlot *free_list = nullptr;
+    };
 
-    void deallocateObject(int type_id, void *obj)
+    struct TypePool
     {
-        std::size_t obj_size = m_obj_sizes.at(type_id);
+        std::size_t slot_size = 0;
+        std::size_t alignment = 0;
+        std::size_t chunk_size = 0;
+        std::size_t first_slot_offset = 0;
+        std::size_t slots_per_chunk = 0;
+
+        std::vector<ChunkHeader *> chunks;
+        std::vector<ChunkHeader *> chunks_with_space;
+        ChunkHeader *spare_chunk = nullptr; //! empty chunk kept around so bursts do not hit malloc
 
-        std::byte *curr_head = m_freelists.at(type_id);
-        m_freelists.at(type_id) = static_cast<std::byte *>(obj);
-        *(static_cast<std::byte **>(obj)) = curr_head;
+        Stats stats;
     };
 
-    void *allocateObject(int type_id)
+    ChunkHeader *newChunk(TypePool &pool);
+    void releaseChunk(TypePool &pool, ChunkHeader *chunk);
+    static bool hasSpace(const TypePool &pool, const ChunkHeader *chunk);
+
+private:
+    std::vector<std::unique_ptr<TypePool>> m_pools; //! indexed by type_id
+};
+
+//! allocator for std::allocate_shared, so that the object and its control block share one slot of the arena
+//! the slot size is known only after rebinding to the control block type, so types are registered lazily
+template <class T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator(ObjectArena &arena, int type_id)
+        : p_arena(&arena), m_type_id(type_id)
+    {
+    }
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other)
+        : p_arena(other.p_arena), m_type_id(other.m_type_id)
+    {
+    }
+
+    T *allocate(std::size_t n)
     {
-        if (m_freelists.count(type_id) == 0)
+        if (n != 1 || !p_arena->registerObject(m_type_id, sizeof(T), alignof(T)))
         {
-            return nullptr;
+            //! someone else uses the type id with different layout, just use the heap
+            return std::allocator<T>{}.allocate(n);
         }
+        return static_cast<T *>(p_arena->allocateObject(m_type_id));
+    }
 
-        std::byte *list_head = m_freelists.at(type_id);
-        std::size_t obj_size = m_obj_sizes.at(type_id);
-
-        // std::cout << "Creating new object a!" << std::endl;
-        if (!list_head) //! new free spot will be placed to the right
+    void deallocate(T *p, std::size_t n)
+    {
+        if (n != 1 || !p_arena->registerObject(m_type_id, sizeof(T), alignof(T)))
         {
-            // std::cout << "Creating new object!" << std::endl;
-            if (m_max_allocated_size + obj_size < m_chunk_list.back().chunk.size())
-            {
-                m_max_allocated_size += obj_size;
-                return (m_chunk_list.back().chunk.data() + (m_max_allocated_size - obj_size));
-            }
-            else //! new obj does not fit inside last chunk -> allocate new chunk
-            {
-                // std::size_t prev_chunk_size = m_chunk_list.back().chunk.size();
-                m_chunk_list.emplace_back(); //! increase size by a factor
-                m_max_allocated_size = obj_size;
-                return m_chunk_list.back().chunk.data();
-            }
+            std::allocator<T>{}.deallocate(p, n);
+            return;
         }
+        p_arena->deallocateObject(m_type_id, p);
+    }
 
-        auto next_head = *(reinterpret_cast<std::byte **>(list_head));
-        m_freelists.at(type_id) = next_head;
-        return list_head;
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const
+    {
+        return p_arena == other.p_arena && m_type_id == other.m_type_id;
     }
 
 private:
-    std::size_t m_max_allocated_size = 0;
-
-    std::unordered_map<int, std::byte *> m_freelists;
-    std::unordered_map<int, std::size_t> m_obj_sizes;
+    template <class U>
+    friend class ArenaAllocator;
 
-    struct alignas(32) Chunk
-    {
-        std::array<std::byte, CHUNK_SIZE> chunk;
-    };
-    std::list<Chunk> m_chunk_list;
-    
+    ObjectArena *p_arena;
+    int m_type_id;
 };
@@ -5,6 +5,7 @@
 #include <Renderer.h>
 
 #include <vector>
+#include <span>
 
 #include "core.h"
 
@@ -27,6 +28,8 @@ struct Polygon : public Transform
   }
 
   std::vector<utils::Vector2f> getPointsInWorld() const;
+  //! same as getPointsInWorld but into a buffer of points.size() elements
+  void writePointsInWorld(std::span<utils::Vector2f> world_points) const;
   void move(utils::Vector2f by);
   void rotate(float by);
   void update(float dt);
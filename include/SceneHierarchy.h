@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class GameObject;
+
+//! entities of a GameWorld stored in one flat array in depth first order,
+//! so every parent comes before its children and every subtree is a contiguous range
+//! updating parents before children is then a linear sweep through the array
+class SceneHierarchy
+{
+public:
+    bool contains(int entity_id) const;
+
+    //! places the object into the subtree of its parent (if the parent is already in), otherwise it becomes a root
+    //! children of the object which are already in are moved under it
+    void insert(GameObject &object);
+
+    //! moves the subtree of the object after its parent changed
+    void reattach(GameObject &object);
+
+    //! appends all objects of the subtree (children first) into removed and marks them for removal,
+    //! objects already marked are skipped; the marked objects stay in order() as nullptr until compact()
+    void markSubtreeForRemoval(GameObject &object, std::vector<GameObject *> &removed);
+
+    //! erases all marked objects in one pass
+    void compact();
+
+    //! parents always precede their children
+    const std::vector<GameObject *> &order() const;
+
+private:
+    void setParentOf(int entity_id, int parent_id);
+    void fixPositions(std::size_t begin, std::size_t end);
+    void addToAncestors(int parent_id, long long delta);
+
+private:
+    std::vector<GameObject *> m_order;
+    std::vector<std::size_t> m_subtree_sizes; //! including the object itself, parallel to m_order
+
+    std::vector<int> m_id2pos;    //! -1 if the entity is not in the hierarchy
+    std::vector<int> m_id2parent; //! parent as placed in the hierarchy, -1 for roots
+};
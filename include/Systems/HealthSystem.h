@@ -6,7 +6,7 @@
 #include "../PostBox.h"
 
 
-class HealthSystem : public SystemI
+class HealthSystem final : public SystemI
 {
 public:
     HealthSystem(utils::ContiguousColony<HealthComponent, int> &comps, PostOffice& m_messenger);
@@ -14,6 +14,7 @@ public:
     virtual void preUpdate(float dt, EntityRegistryT &entities) override;
     virtual void postUpdate(float dt, EntityRegistryT &entities) override;
     virtual void update(float dt) override;
+    virtual SystemAccess getAccess() const override;
 
 private:
     utils::ContiguousColony<HealthComponent, int> &m_components;
@@ -2,22 +2,25 @@
 
 #include "System.h"
 #include "Components.h"
+#include "../TransformStore.h"
 
 class LayersHolder;
 class Path;
 
-class PathSystem : public SystemI
+class PathSystem final : public SystemI
 {
 public:
-    PathSystem(utils::ContiguousColony<PathComponent, int> &boids, LayersHolder& layers);
+    PathSystem(utils::ContiguousColony<PathComponent, int> &boids, TransformStore &transforms, LayersHolder& layers);
 
     virtual void preUpdate(float dt, EntityRegistryT &entities) override;
     virtual void postUpdate(float dt, EntityRegistryT &entities) override;
     virtual void update(float dt) override;
+    virtual SystemAccess getAccess() const override;
 
 private:
     //! I could also store all of the sprite data directly in PathBatch to avoid copying
     //! But it's not a bottleneck right now so who cares?
     utils::ContiguousColony<PathComponent, int> &m_components;
+    TransformStore &m_transforms;
     LayersHolder& m_layers;
 };
@@ -2,23 +2,32 @@
 
 #include "System.h"
 #include "Components.h"
+#include "../TransformStore.h"
+#include "../Utils/ParallelFor.h"
 class LayersHolder;
 
 
-class SpriteSystem : public SystemI
+class SpriteSystem final : public SystemI
 {
 public:
-    SpriteSystem(utils::ContiguousColony<SpriteComponent, int> &boids, LayersHolder& layers);
+    SpriteSystem(utils::ContiguousColony<SpriteComponent, int> &boids, TransformStore &transforms, LayersHolder& layers);
 
     virtual void preUpdate(float dt, EntityRegistryT &entities) override;
     virtual void postUpdate(float dt, EntityRegistryT &entities) override;
     virtual void update(float dt) override;
+    //! sprites are put into layers here and not in update, so a frame with no or several updates draws them once
+    virtual void draw() override;
+    virtual SystemAccess getAccess() const override;
 
 private:
     //! I could also store all of the sprite data directly in SpriteBatch to avoid copying
     //! But it's not a bottleneck right now so who cares?
     utils::ContiguousColony<SpriteComponent, int> &m_components;
+    TransformStore &m_transforms;
     LayersHolder& m_layers;
+
+    std::uint64_t m_seen_components_version = 0;
+    std::uint64_t m_seen_transforms_version = 0;
 };
 
 /* class ParticleSystem : public SystemI
@@ -38,18 +47,23 @@ private:
 };
  */
 
-class TransformSystem : public SystemI
+class TransformSystem final : public SystemI
 {
 public:
-    TransformSystem(utils::ContiguousColony<TransformComponent, int> &boids);
+    TransformSystem(utils::ContiguousColony<TransformComponent, int> &boids, TransformStore &transforms);
 
     virtual void preUpdate(float dt, EntityRegistryT &entities) override;
     virtual void postUpdate(float dt, EntityRegistryT &entities) override;
     virtual void update(float dt) override;
+    virtual SystemAccess getAccess() const override;
 
 private:
     //! I could also store all of the sprite data directly in SpriteBatch to avoid copying
     //! But it's not a bottleneck right now so who cares?
     utils::ContiguousColony<TransformComponent, int> &m_components;
+    TransformStore &m_transforms;
+
+    utils::DeferredWrites<std::pair<int, utils::Vector2f>> m_moves;
+    utils::DeferredWrites<int> m_to_destroy;
 };
 
@@ -6,9 +6,68 @@
 #include "../Utils/ObjectPool.h"
 
 #include <memory>
-#include <queue>
+#include <functional>
+#include <vector>
+#include <typeindex>
+#include <algorithm>
+
+namespace utils
+{
+    class ThreadPool;
+}
 
 using EntityRegistryT = utils::DynamicObjectPool2<std::shared_ptr<GameObject>>;
+using EntityHandle = utils::Handle;
+
+//! declares which data a system touches, so that the scheduler knows which systems may run concurrently
+//! components are identified by their types, entities (the GameObjects themselves) by GameObject,
+//! positions, angles and sizes by TransformStore (GameObject setters write it too)
+//! or anything else shared (e.g. LayersHolder when drawing)
+struct SystemAccess
+{
+    std::vector<std::type_index> reads;
+    std::vector<std::type_index> writes;
+    bool exclusive = false; //! runs alone, for systems calling arbitrary callbacks
+
+    template <class... Types>
+    SystemAccess &read()
+    {
+        (reads.push_back(typeid(Types)), ...);
+        return *this;
+    }
+
+    template <class... Types>
+    SystemAccess &write()
+    {
+        (writes.push_back(typeid(Types)), ...);
+        return *this;
+    }
+
+    static SystemAccess makeExclusive()
+    {
+        SystemAccess access;
+        access.exclusive = true;
+        return access;
+    }
+
+    //! two systems conflict if one writes something the other one reads or writes
+    bool conflictsWith(const SystemAccess &other) const
+    {
+        if (exclusive || other.exclusive)
+        {
+            return true;
+        }
+        auto touches = [](const SystemAccess &access, std::type_index type)
+        {
+            return std::find(access.reads.begin(), access.reads.end(), type) != access.reads.end() ||
+                   std::find(access.writes.begin(), access.writes.end(), type) != access.writes.end();
+        };
+        return std::any_of(writes.begin(), writes.end(), [&](auto type)
+                           { return touches(other, type); }) ||
+               std::any_of(other.writes.begin(), other.writes.end(), [&](auto type)
+                           { return touches(*this, type); });
+    }
+};
 
 class SystemI
 {
@@ -17,8 +76,25 @@ public:
     virtual void preUpdate(float dt, EntityRegistryT& entities) = 0;
     virtual void update(float dt) = 0;
     virtual void postUpdate(float dt, EntityRegistryT& entities) = 0;
+    //! called once per drawn frame, which need not match the number of updates, always on the calling thread
+    virtual void draw() {}
+
+    //! systems which do not declare what they access are never run in parallel with others
+    virtual SystemAccess getAccess() const
+    {
+        return SystemAccess::makeExclusive();
+    }
     
+    //! pool the system may spread its per component loops over, nullptr means single threaded
+    void setThreadPool(utils::ThreadPool *pool)
+    {
+        p_pool = pool;
+    }
+
     virtual ~SystemI(){};
+
+protected:
+    utils::ThreadPool *p_pool = nullptr;
 };
 
 template <class ComponentType>
@@ -40,30 +116,76 @@ public:
         return m_components.contains(entity_id);
     }
 
+    //! structural changes recorded during update are applied in one batch by applyWaiting()
     void addDelayed(ComponentType&& comp, int entity_id)
     {
-        m_to_add.push({std::move(comp), entity_id});
+        m_commands.push_back({entity_id, static_cast<int>(m_commands.size()), static_cast<int>(m_to_add.size())});
+        m_to_add.push_back(std::move(comp));
     }
 
-    void addWaiting()
+    //! applies the recorded changes, for every entity only the last recorded one counts:
+    //! remove then add leaves the entity with the added component, add then remove leaves it without one
+    //! the buffers keep their capacity so after the first few frames nothing is allocated
+    void applyWaiting()
     {
-        while(!m_to_add.empty())
+        if (m_commands.empty())
         {
-            auto& [comp, id] = m_to_add.front();
-            add(std::move(comp), id);
-            m_to_add.pop();
+            return;
         }
-    }
 
-    void removeWaiting()
-    {
-        while(!m_to_remove.empty())
+        //! commands of an entity end up next to each other in the order in which they were recorded
+        std::sort(m_commands.begin(), m_commands.end(), [](const Command &a, const Command &b)
+                  { return a.entity_id < b.entity_id || (a.entity_id == b.entity_id && a.seq < b.seq); });
+        auto is_last_of_entity = [this](std::size_t i)
+        {
+            return i + 1 == m_commands.size() || m_commands[i + 1].entity_id != m_commands[i].entity_id;
+        };
+
+        //! erasing from the back of the colony first means the swap-and-pop mostly moves elements which stay
+        m_remove_order.clear();
+        for (std::size_t i = 0; i < m_commands.size(); ++i)
+        {
+            auto id = m_commands[i].entity_id;
+            if (is_last_of_entity(i) && m_commands[i].add_ind < 0 && has(id))
+            {
+                m_remove_order.push_back(m_components.getDataInd(id));
+            }
+        }
+        std::sort(m_remove_order.begin(), m_remove_order.end(), std::greater<>());
+        for (auto data_ind : m_remove_order)
+        {
+            m_components.erase(m_components.data_ind2id[data_ind]);
+        }
+
+        for (std::size_t i = 0; i < m_commands.size(); ++i)
         {
-            auto id = m_to_remove.front();
-            m_to_remove.pop();
-            m_components.erase(id);
+            auto [id, seq, add_ind] = m_commands[i];
+            if (!is_last_of_entity(i) || add_ind < 0)
+            {
+                continue;
+            }
+            if (has(id))
+            {
+                m_components.get(id) = std::move(m_to_add[add_ind]);
+                m_components.markChanged(id);
+            }
+            else
+            {
+                add(std::move(m_to_add[add_ind]), id);
+            }
         }
+
+        m_to_add.clear();
+        m_commands.clear();
+    }
+
+    //! forgets the recorded changes without applying them
+    void clearWaiting()
+    {
+        m_to_add.clear();
+        m_commands.clear();
     }
+
     void add(ComponentType&& comp, int entity_id)
     {
         m_components.insert(entity_id, std::move(comp));
@@ -78,12 +200,29 @@ public:
     }
     void eraseDelayed(int entity_id)
     {
-        m_to_remove.push(entity_id);
+        m_commands.push_back({entity_id, static_cast<int>(m_commands.size()), -1});
+    }
+
+    void shrink_to_fit()
+    {
+        m_components.shrink_to_fit();
+        m_to_add.shrink_to_fit();
+        m_commands.shrink_to_fit();
+        m_remove_order.shrink_to_fit();
     }
 
 private:
-    std::queue<std::pair<ComponentType, int>> m_to_add;
-    std::queue<int> m_to_remove;
+    //! a recorded add or remove, seq is its position in the recording order, add_ind is -1 for removes
+    struct Command
+    {
+        int entity_id;
+        int seq;
+        int add_ind;
+    };
+
+    std::vector<Command> m_commands;
+    std::vector<ComponentType> m_to_add;
+    std::vector<std::size_t> m_remove_order;
     
     utils::ContiguousColony<ComponentType, int> m_components;
 };
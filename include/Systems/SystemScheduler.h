@@ -0,0 +1,48 @@
+#pragma once
+
+#include "System.h"
+
+#include <vector>
+#include <memory>
+#include <typeindex>
+
+namespace utils
+{
+    class ThreadPool;
+}
+
+//! runs the systems in batches: systems in one batch do not conflict and may run in parallel,
+//! a system is always placed after every earlier registered system it conflicts with.
+//! So the result does not depend on the number of threads and conflicting systems run in registration order.
+class SystemScheduler
+{
+public:
+    //! a system of an already registered type replaces the old one at its place
+    void add(std::shared_ptr<SystemI> p_system);
+
+    //! nullptr means everything runs on the calling thread
+    void setThreadPool(utils::ThreadPool *pool);
+
+    void preUpdate(float dt, EntityRegistryT &entities);
+    void update(float dt);
+    void postUpdate(float dt, EntityRegistryT &entities);
+    //! in registration order
+    void draw();
+
+    const std::vector<std::vector<std::size_t>> &getBatches();
+
+private:
+    void rebuildBatches();
+    template <class SystemCall>
+    void runBatches(SystemCall &&call);
+
+private:
+    std::vector<std::shared_ptr<SystemI>> m_systems; //! in registration order
+    std::vector<std::type_index> m_system_types;
+    std::vector<SystemAccess> m_accesses;
+
+    std::vector<std::vector<std::size_t>> m_batches;
+    bool m_batches_dirty = false;
+
+    utils::ThreadPool *p_pool = nullptr;
+};
@@ -22,6 +22,7 @@ public:
     void removeEvent(TimedEventId id);
     void clear();
     void update(float dt);
+    bool isEmpty();
 
 private:
     std::vector<TimedEventId> m_to_destroy;
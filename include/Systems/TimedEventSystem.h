@@ -3,7 +3,7 @@
 #include "System.h"
 #include "../Components.h"
 
-class TimedEventSystem : public SystemI
+class TimedEventSystem final : public SystemI
 {
 public:
     TimedEventSystem(utils::ContiguousColony<TimedEventComponent, int> &comps);
@@ -11,6 +11,7 @@ public:
     virtual void preUpdate(float dt, EntityRegistryT &entities) override;
     virtual void postUpdate(float dt, EntityRegistryT &entities) override;
     virtual void update(float dt) override;
+    //! timed events run arbitrary callbacks so the system keeps the default exclusive access
 
 private:
     utils::ContiguousColony<TimedEventComponent, int> &m_components;
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <cmath>
+
+#include <Utils/Vector2.h>
+
+#include "Utils/BinaryStream.h"
+
+//! Holds local transforms of all entities of a GameWorld as structure of arrays indexed by entity id.
+//! The data is split into fixed size pages which never move once allocated,
+//! so GameObjects can keep references to their slot while systems stream through the arrays.
+//! Every slot also remembers the version of its last change, so systems can skip entities which did not move.
+//! Positions and angles of the previous simulation step are kept aside, so frames drawn between two steps can be interpolated.
+class TransformStore
+{
+public:
+    static constexpr std::size_t PAGE_BITS = 8;
+    static constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_BITS;
+    static constexpr std::size_t PAGE_MASK = PAGE_SIZE - 1;
+
+    struct Page
+    {
+        std::array<utils::Vector2f, PAGE_SIZE> positions;
+        std::array<float, PAGE_SIZE> angles;
+        std::array<utils::Vector2f, PAGE_SIZE> sizes;
+        std::array<utils::Vector2f, PAGE_SIZE> pivots;
+        std::array<int, PAGE_SIZE> parents; //! -1 for roots
+        std::array<std::uint64_t, PAGE_SIZE> versions;
+
+        BOOST_DESCRIBE_CLASS(Page, (), (positions, angles, sizes, pivots, parents, versions), (), ())
+    };
+
+    //! state of the previous step, kept out of Page so snapshots do not carry it
+    struct HistoryPage
+    {
+        std::array<utils::Vector2f, PAGE_SIZE> prev_positions;
+        std::array<float, PAGE_SIZE> prev_angles;
+        std::array<bool, PAGE_SIZE> has_previous; //! slots claimed during the step have nothing to interpolate from
+        std::array<utils::Vector2f, PAGE_SIZE> stashed_positions;
+        std::array<float, PAGE_SIZE> stashed_angles;
+    };
+
+    //! makes sure the slot exists and resets it to a root with identity transform
+    void claim(int slot)
+    {
+        assert(slot >= 0);
+        assert(!m_interpolating);
+        auto page_ind = static_cast<std::size_t>(slot) >> PAGE_BITS;
+        allocatePage(page_ind);
+        auto &page = *m_pages[page_ind];
+        auto ind = slot & PAGE_MASK;
+        m_history[page_ind]->has_previous[ind] = false;
+        page.positions[ind] = {0.f, 0.f};
+        page.angles[ind] = 0.f;
+        page.sizes[ind] = {1.f, 1.f};
+        page.pivots[ind] = {0.f, 0.f};
+        page.parents[ind] = -1;
+        stamp(page, slot);
+    }
+
+    void markChanged(int slot)
+    {
+        assert(!m_interpolating); //! the write would be lost by endInterpolation
+        stamp(page(slot), slot);
+    }
+
+    //! calls fn(slot) for slots changed since the last drain (a slot may rarely come twice, also slots of dead entities come)
+    //! changes of parents are not propagated to children here
+    template <class Fn>
+    void drainChanged(Fn &&fn)
+    {
+        for (auto slot : m_changed_slots)
+        {
+            fn(slot);
+        }
+        m_changed_slots.clear();
+        m_drained_version = m_version;
+    }
+
+    //! version of the last change of any slot, systems remember it to know what they have already seen
+    std::uint64_t currentVersion() const
+    {
+        return m_version;
+    }
+
+    //! true if the world transform of the slot changed after the given version (so changes of parents count)
+    bool changedSince(int slot, std::uint64_t version)
+    {
+        while (slot != -1)
+        {
+            auto &p = page(slot);
+            auto ind = slot & PAGE_MASK;
+            if (p.versions[ind] > version)
+            {
+                return true;
+            }
+            slot = p.parents[ind];
+        }
+        return false;
+    }
+
+    //! write access, not allowed between beginInterpolation and endInterpolation
+    utils::Vector2f &position(int slot)
+    {
+        assert(!m_interpolating);
+        return page(slot).positions[slot & PAGE_MASK];
+    }
+    float &angle(int slot)
+    {
+        assert(!m_interpolating);
+        return page(slot).angles[slot & PAGE_MASK];
+    }
+    utils::Vector2f &size(int slot)
+    {
+        assert(!m_interpolating);
+        return page(slot).sizes[slot & PAGE_MASK];
+    }
+    utils::Vector2f &pivot(int slot)
+    {
+        assert(!m_interpolating);
+        return page(slot).pivots[slot & PAGE_MASK];
+    }
+    int &parent(int slot)
+    {
+        assert(!m_interpolating);
+        return page(slot).parents[slot & PAGE_MASK];
+    }
+
+    //! same as GameObject::getPosition() but without touching the object
+    utils::Vector2f worldPosition(int slot)
+    {
+        auto &p = page(slot);
+        auto ind = slot & PAGE_MASK;
+        utils::Vector2f origin = {p.pivots[ind].x * p.sizes[ind].x, p.pivots[ind].y * p.sizes[ind].y};
+        if (p.parents[ind] != -1)
+        {
+            auto r = utils::rotate(-origin, p.angles[ind]) + p.positions[ind];
+            return worldPosition(p.parents[ind]) + utils::rotate(r, worldAngle(p.parents[ind]));
+        }
+        return p.positions[ind] - utils::rotate(origin, p.angles[ind]);
+    }
+
+    //! same as GameObject::getAngle()
+    float worldAngle(int slot)
+    {
+        auto &p = page(slot);
+        auto ind = slot & PAGE_MASK;
+        if (p.parents[ind] != -1)
+        {
+            return p.angles[ind] + worldAngle(p.parents[ind]);
+        }
+        return p.angles[ind];
+    }
+
+    //! remembers the current state as the previous step, called at the start of every simulation step
+    void storePrevious()
+    {
+        assert(!m_interpolating);
+        for (std::size_t page_ind = 0; page_ind < m_pages.size(); ++page_ind)
+        {
+            if (!m_pages[page_ind])
+            {
+                continue;
+            }
+            auto &history = *m_history[page_ind];
+            history.prev_positions = m_pages[page_ind]->positions;
+            history.prev_angles = m_pages[page_ind]->angles;
+            history.has_previous.fill(true);
+        }
+    }
+
+    //! temporarily replaces positions and angles by the blend of the previous and current step (alpha = 1 is the current one)
+    //! everything drawn until endInterpolation() then sees the blended transforms, nothing may be written meanwhile
+    void beginInterpolation(float alpha)
+    {
+        assert(!m_interpolating);
+        m_interpolating = true;
+        for (std::size_t page_ind = 0; page_ind < m_pages.size(); ++page_ind)
+        {
+            if (!m_pages[page_ind])
+            {
+                continue;
+            }
+            auto &page = *m_pages[page_ind];
+            auto &history = *m_history[page_ind];
+            history.stashed_positions = page.positions;
+            history.stashed_angles = page.angles;
+            for (std::size_t ind = 0; ind < PAGE_SIZE; ++ind)
+            {
+                if (!history.has_previous[ind])
+                {
+                    continue;
+                }
+                auto &prev_pos = history.prev_positions[ind];
+                page.positions[ind] = prev_pos + (page.positions[ind] - prev_pos) * alpha;
+                page.angles[ind] = interpolateAngle(history.prev_angles[ind], page.angles[ind], alpha);
+            }
+        }
+    }
+
+    void endInterpolation()
+    {
+        assert(m_interpolating);
+        m_interpolating = false;
+        for (std::size_t page_ind = 0; page_ind < m_pages.size(); ++page_ind)
+        {
+            if (!m_pages[page_ind])
+            {
+                continue;
+            }
+            m_pages[page_ind]->positions = m_history[page_ind]->stashed_positions;
+            m_pages[page_ind]->angles = m_history[page_ind]->stashed_angles;
+        }
+    }
+
+    //! pages are trivially copyable so they are written as they are
+    void writeSnapshot(utils::BinaryWriter &writer) const
+    {
+        utils::writeBinary(writer, m_pages.size());
+        for (auto &p_page : m_pages)
+        {
+            bool has_page = p_page != nullptr;
+            utils::writeBinary(writer, has_page);
+            if (has_page)
+            {
+                utils::writeBinary(writer, *p_page);
+            }
+        }
+    }
+
+    //! pages are never freed because GameObjects hold references into them,
+    //! slots missing in the snapshot keep their values, restored slots count as changed
+    void readSnapshot(utils::BinaryReader &reader)
+    {
+        std::size_t page_count;
+        utils::readBinary(reader, page_count);
+        const auto version = ++m_version;
+        for (std::size_t page_ind = 0; page_ind < page_count; ++page_ind)
+        {
+            bool has_page;
+            utils::readBinary(reader, has_page);
+            if (!has_page)
+            {
+                continue;
+            }
+            allocatePage(page_ind);
+            utils::readBinary(reader, *m_pages[page_ind]);
+            m_pages[page_ind]->versions.fill(version);
+            m_history[page_ind]->has_previous.fill(false); //! restoring is a jump, not a movement
+            for (std::size_t ind = 0; ind < PAGE_SIZE; ++ind)
+            {
+                m_changed_slots.push_back(static_cast<int>((page_ind << PAGE_BITS) + ind));
+            }
+        }
+    }
+
+    std::size_t pageCount() const
+    {
+        return m_pages.size();
+    }
+
+private:
+    void allocatePage(std::size_t page_ind)
+    {
+        if (page_ind >= m_pages.size())
+        {
+            m_pages.resize(page_ind + 1);
+            m_history.resize(page_ind + 1);
+        }
+        if (!m_pages[page_ind])
+        {
+            m_pages[page_ind] = std::make_unique<Page>();
+            m_history[page_ind] = std::make_unique<HistoryPage>();
+            m_history[page_ind]->has_previous.fill(false);
+        }
+    }
+
+    //! angles are in degrees, the blend goes the shorter way around
+    static float interpolateAngle(float from, float to, float alpha)
+    {
+        float diff = std::fmod(to - from, 360.f);
+        if (diff > 180.f)
+        {
+            diff -= 360.f;
+        }
+        else if (diff < -180.f)
+        {
+            diff += 360.f;
+        }
+        return from + diff * alpha;
+    }
+
+    //! the slot is logged only on its first change after the last drain
+    void stamp(Page &page, int slot)
+    {
+        auto &version = page.versions[slot & PAGE_MASK];
+        if (version <= m_drained_version)
+        {
+            m_changed_slots.push_back(slot);
+        }
+        version = ++m_version;
+    }
+
+    Page &page(int slot)
+    {
+        auto page_ind = static_cast<std::size_t>(slot) >> PAGE_BITS;
+        assert(page_ind < m_pages.size() && m_pages[page_ind]);
+        return *m_pages[page_ind];
+    }
+
+private:
+    std::vector<std::unique_ptr<Page>> m_pages;
+    std::vector<std::unique_ptr<HistoryPage>> m_history; //! parallel to m_pages
+    bool m_interpolating = false;
+    std::uint64_t m_version = 0;
+
+    std::vector<int> m_changed_slots;
+    std::uint64_t m_drained_version = 0;
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+
+#include "boost/describe.hpp"
+#include "boost/mp11.hpp"
+
+#include <Utils/Vector2.h>
+#include <Rect.h>
+
+namespace utils
+{
+
+    //! appends raw bytes to a blob, the blob keeps its memory between snapshots
+    class BinaryWriter
+    {
+    public:
+        explicit BinaryWriter(std::vector<std::byte> &blob)
+            : m_blob(blob)
+        {
+        }
+
+        void writeBytes(const void *bytes, std::size_t n_bytes)
+        {
+            auto old_size = m_blob.size();
+            m_blob.resize(old_size + n_bytes);
+            if (n_bytes > 0)
+            {
+                std::memcpy(m_blob.data() + old_size, bytes, n_bytes);
+            }
+        }
+
+    private:
+        std::vector<std::byte> &m_blob;
+    };
+
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(const std::vector<std::byte> &blob)
+            : m_blob(blob)
+        {
+        }
+
+        void readBytes(void *bytes, std::size_t n_bytes)
+        {
+            assert(m_position + n_bytes <= m_blob.size());
+            if (n_bytes > 0)
+            {
+                std::memcpy(bytes, m_blob.data() + m_position, n_bytes);
+            }
+            m_position += n_bytes;
+        }
+
+        bool isAtEnd() const
+        {
+            return m_position == m_blob.size();
+        }
+
+    private:
+        const std::vector<std::byte> &m_blob;
+        std::size_t m_position = 0;
+    };
+
+    template <class T>
+    struct IsVector : std::false_type
+    {
+    };
+    template <class T, class Alloc>
+    struct IsVector<std::vector<T, Alloc>> : std::true_type
+    {
+    };
+
+    template <class T>
+    struct IsArray : std::false_type
+    {
+    };
+    template <class T, std::size_t N>
+    struct IsArray<std::array<T, N>> : std::true_type
+    {
+    };
+
+    //! opt in for trivially copyable types which are not described but are known to hold only plain values
+    //! a trivially copyable struct can still hold pointers (e.g. to its owner), so it is not written unless it opts in
+    template <class T>
+    struct IsBlittable : std::false_type
+    {
+    };
+    template <class T>
+    struct IsBlittable<Vector2<T>> : std::true_type
+    {
+    };
+    template <class T>
+    struct IsBlittable<Rect<T>> : std::true_type
+    {
+    };
+
+    //! numbers, enums and types opting in through IsBlittable are memcpied, strings and vectors are prefixed by their size
+    //! and described structs (BOOST_DESCRIBE_STRUCT) are checked member by member (and memcpied if they are trivially copyable)
+    //! anything else (pointers to owners, callbacks...) cannot be written into a blob
+    template <class T>
+    constexpr bool isBinarySerializable()
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        {
+            return true;
+        }
+        else if constexpr (std::is_pointer_v<T> || std::is_member_pointer_v<T>)
+        {
+            return false;
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            return true;
+        }
+        else if constexpr (IsVector<T>::value || IsArray<T>::value)
+        {
+            return isBinarySerializable<typename T::value_type>();
+        }
+        else if constexpr (boost::describe::has_describe_members<T>::value)
+        {
+            using Members = boost::describe::describe_members<T, boost::describe::mod_any_access | boost::describe::mod_inherited>;
+            bool result = true;
+            boost::mp11::mp_for_each<Members>([&](auto member)
+                                              {
+                using MemberType = std::decay_t<decltype(std::declval<T &>().*member.pointer)>;
+                result = result && isBinarySerializable<MemberType>(); });
+            return result;
+        }
+        else if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            return IsBlittable<T>::value;
+        }
+        return false;
+    }
+
+    template <class T>
+    void writeBinary(BinaryWriter &writer, const T &value)
+    {
+        static_assert(isBinarySerializable<T>());
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            writer.writeBytes(&value, sizeof(T));
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            writeBinary(writer, value.size());
+            writer.writeBytes(value.data(), value.size());
+        }
+        else if constexpr (IsArray<T>::value)
+        {
+            for (auto &element : value)
+            {
+                writeBinary(writer, element);
+            }
+        }
+        else if constexpr (IsVector<T>::value)
+        {
+            writeBinary(writer, value.size());
+            using ValueType = typename T::value_type;
+            if constexpr (std::is_trivially_copyable_v<ValueType>)
+            {
+                writer.writeBytes(value.data(), value.size() * sizeof(ValueType));
+            }
+            else
+            {
+                for (auto &element : value)
+                {
+                    writeBinary(writer, element);
+                }
+            }
+        }
+        else
+        {
+            using Members = boost::describe::describe_members<T, boost::describe::mod_any_access | boost::describe::mod_inherited>;
+            boost::mp11::mp_for_each<Members>([&](auto member)
+                                              { writeBinary(writer, value.*member.pointer); });
+        }
+    }
+
+    template <class T>
+    void readBinary(BinaryReader &reader, T &value)
+    {
+        static_assert(isBinarySerializable<T>());
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            reader.readBytes(&value, sizeof(T));
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            std::size_t size;
+            readBinary(reader, size);
+            value.resize(size);
+            reader.readBytes(value.data(), size);
+        }
+        else if constexpr (IsArray<T>::value)
+        {
+            for (auto &element : value)
+            {
+                readBinary(reader, element);
+            }
+        }
+        else if constexpr (IsVector<T>::value)
+        {
+            std::size_t size;
+            readBinary(reader, size);
+            using ValueType = typename T::value_type;
+            if constexpr (std::is_trivially_copyable_v<ValueType>)
+            {
+                value.resize(size);
+                reader.readBytes(value.data(), size * sizeof(ValueType));
+            }
+            else
+            {
+                value.resize(size);
+                for (auto &element : value)
+                {
+                    readBinary(reader, element);
+                }
+            }
+        }
+        else
+        {
+            using Members = boost::describe::describe_members<T, boost::describe::mod_any_access | boost::describe::mod_inherited>;
+            boost::mp11::mp_for_each<Members>([&](auto member)
+                                              { readBinary(reader, value.*member.pointer); });
+        }
+    }
+
+} //! namespace utils
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <tuple>
+#include <array>
+#include <vector>
+#include <cstddef>
+
+#include "ContiguousColony.h"
+
+namespace utils
+{
+
+    //! joins several colonies sharing the same ids
+    //! iterates the ids of the smallest colony and resolves the rest through their sparse index
+    //! the smallest colony itself is read at the data index, so a view over one colony costs the same as an index loop
+    //! usage: for (auto [id, sprite, health] : ColonyView(sprites, healths)) {...}
+    template <class IdType, class... DataTypes>
+    class ColonyView
+    {
+        static_assert(sizeof...(DataTypes) > 0);
+
+        using Colonies = std::tuple<ContiguousColony<DataTypes, IdType> *...>;
+
+    public:
+        using value_type = std::tuple<IdType, DataTypes &...>;
+
+        explicit ColonyView(ContiguousColony<DataTypes, IdType> &...colonies)
+            : m_colonies(&colonies...)
+        {
+            std::array<const std::vector<IdType> *, sizeof...(DataTypes)> ids = {&colonies.data_ind2id...};
+            m_driver_ids = ids[0];
+            for (auto p_ids : ids)
+            {
+                if (p_ids->size() < m_driver_ids->size())
+                {
+                    m_driver_ids = p_ids;
+                }
+            }
+        }
+
+        class Iterator
+        {
+        public:
+            Iterator(const ColonyView &view, std::size_t data_ind)
+                : m_view(&view), m_data_ind(data_ind)
+            {
+                skipMissing();
+            }
+
+            value_type operator*() const
+            {
+                IdType id = (*m_view->m_driver_ids)[m_data_ind];
+                return std::apply([this, id](auto *...colonies)
+                                  { return value_type{id, m_view->resolve(*colonies, id, m_data_ind)...}; },
+                                  m_view->m_colonies);
+            }
+
+            Iterator &operator++()
+            {
+                m_data_ind++;
+                skipMissing();
+                return *this;
+            }
+
+            bool operator==(const Iterator &other) const
+            {
+                return m_data_ind == other.m_data_ind;
+            }
+
+        private:
+            //! moves to the next id which is present in all colonies
+            void skipMissing()
+            {
+                const auto &ids = *m_view->m_driver_ids;
+                while (m_data_ind < ids.size() && !m_view->containsAll(ids[m_data_ind]))
+                {
+                    m_data_ind++;
+                }
+            }
+
+        private:
+            const ColonyView *m_view;
+            std::size_t m_data_ind;
+        };
+
+        Iterator begin() const
+        {
+            return {*this, 0};
+        }
+        Iterator end() const
+        {
+            return {*this, m_driver_ids->size()};
+        }
+
+        //! upper bound on the number of joined elements
+        std::size_t sizeHint() const
+        {
+            return m_driver_ids->size();
+        }
+
+    private:
+        bool containsAll(IdType id) const
+        {
+            return std::apply([this, id](auto *...colonies)
+                              { return ((&colonies->data_ind2id == m_driver_ids || colonies->contains(id)) && ...); },
+                              m_colonies);
+        }
+
+        template <class DataType>
+        DataType &resolve(ContiguousColony<DataType, IdType> &colony, IdType id, std::size_t data_ind) const
+        {
+            if (&colony.data_ind2id == m_driver_ids)
+            {
+                return colony.data[data_ind];
+            }
+            return colony.get(id);
+        }
+
+    private:
+        Colonies m_colonies;
+        const std::vector<IdType> *m_driver_ids;
+    };
+
+} //! namespace utils
@@ -1,27 +1,148 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
+#include <array>
+#include <memory>
+#include <limits>
+#include <cstdint>
 #include <unordered_set>
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 namespace utils
 {
 
+    //! maps (dense, non-negative) ids to slots in the packed data of a colony
+    //! the ids are split into fixed size pages which are allocated only when an id from the page is first inserted
+    //! so lookup is just two indexations and insert/erase never allocates nodes like unordered_map does
+    template <class IdType, std::size_t PAGE_BITS = 10>
+    class PagedSparseIndex
+    {
+    public:
+        static constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_BITS;
+        static constexpr std::size_t PAGE_MASK = PAGE_SIZE - 1;
+        static constexpr std::size_t EMPTY = std::numeric_limits<std::size_t>::max();
+
+        bool contains(IdType id) const
+        {
+            return find(id) != EMPTY;
+        }
+
+        //! returns EMPTY if the id is not in the index
+        std::size_t find(IdType id) const
+        {
+            const auto uid = static_cast<std::size_t>(id); //! negative ids wrap around to huge pages -> not found
+            const auto page_ind = uid >> PAGE_BITS;
+            if (page_ind >= m_pages.size() || !m_pages[page_ind])
+            {
+                return EMPTY;
+            }
+            return (*m_pages[page_ind])[uid & PAGE_MASK];
+        }
+
+        //! throws std::out_of_range for ids which are not in the index, like std::unordered_map::at
+        std::size_t at(IdType id) const
+        {
+            auto data_ind = find(id);
+            if (data_ind == EMPTY)
+            {
+                throw std::out_of_range("PagedSparseIndex: id not found");
+            }
+            return data_ind;
+        }
+
+        std::size_t &at(IdType id)
+        {
+            if (!contains(id))
+            {
+                throw std::out_of_range("PagedSparseIndex: id not found");
+            }
+            const auto uid = static_cast<std::size_t>(id);
+            return (*m_pages[uid >> PAGE_BITS])[uid & PAGE_MASK];
+        }
+
+        void set(IdType id, std::size_t data_ind)
+        {
+            assert(id >= 0);
+            const auto uid = static_cast<std::size_t>(id);
+            const auto page_ind = uid >> PAGE_BITS;
+            if (page_ind >= m_pages.size())
+            {
+                m_pages.resize(page_ind + 1);
+            }
+            auto &page = m_pages[page_ind];
+            if (!page)
+            {
+                page = std::make_unique<Page>();
+                page->fill(EMPTY);
+            }
+            (*page)[uid & PAGE_MASK] = data_ind;
+        }
+
+        void erase(IdType id)
+        {
+            assert(contains(id));
+            const auto uid = static_cast<std::size_t>(id);
+            (*m_pages[uid >> PAGE_BITS])[uid & PAGE_MASK] = EMPTY;
+        }
+
+        //! keeps the allocated pages so the ids can be reused without allocating
+        void clear()
+        {
+            for (auto &page : m_pages)
+            {
+                if (page)
+                {
+                    page->fill(EMPTY);
+                }
+            }
+        }
+
+        //! frees pages which contain no ids
+        void shrink_to_fit()
+        {
+            for (auto &page : m_pages)
+            {
+                if (page && std::all_of(page->begin(), page->end(), [](auto ind)
+                                        { return ind == EMPTY; }))
+                {
+                    page.reset();
+                }
+            }
+            while (!m_pages.empty() && !m_pages.back())
+            {
+                m_pages.pop_back();
+            }
+            m_pages.shrink_to_fit();
+        }
+
+        std::size_t bytesReserved() const
+        {
+            std::size_t page_count = std::count_if(m_pages.begin(), m_pages.end(), [](const auto &page)
+                                                   { return page != nullptr; });
+            return page_count * sizeof(Page) + m_pages.capacity() * sizeof(m_pages[0]);
+        }
+
+    private:
+        using Page = std::array<std::size_t, PAGE_SIZE>;
+        std::vector<std::unique_ptr<Page>> m_pages;
+    };
+
     template <class DataType, class IdType>
     struct ContiguousColony
     {
-        ContiguousColony()
+        //! nothing is reserved by default, the arrays grow geometrically as data are inserted
+        explicit ContiguousColony(std::size_t capacity_hint = 0)
         {
-            //! TODO: DO NOT BE AN IDIOT AND FIX THIS! THE MEMORY SHOULD BE STATICALLY ALLOCATED ANYWAY
-            data.reserve(5000);
-            data_ind2id.reserve(5000);
+            reserve(capacity_hint);
         }
 
         void clear()
         {
             data.clear();
             data_ind2id.clear();
+            data_versions.clear();
             id2data_ind.clear();
         }
 
@@ -29,38 +150,125 @@ namespace utils
         {
             data.reserve(new_size);
             data_ind2id.reserve(new_size);
+            data_versions.reserve(new_size);
+        }
+
+        //! releases the memory reserved beyond the current size (e.g. after a level with many entities)
+        void shrink_to_fit()
+        {
+            data.shrink_to_fit();
+            data_ind2id.shrink_to_fit();
+            data_versions.shrink_to_fit();
+            id2data_ind.shrink_to_fit();
+        }
+
+        std::size_t capacity() const
+        {
+            return data.capacity();
+        }
+
+        //! bytes taken by the stored data (not counting memory owned by the data themselves)
+        std::size_t bytesUsed() const
+        {
+            return data.size() * (sizeof(DataType) + sizeof(IdType) + sizeof(std::uint64_t));
+        }
+
+        std::size_t bytesReserved() const
+        {
+            return data.capacity() * sizeof(DataType) + data_ind2id.capacity() * sizeof(IdType) +
+                   data_versions.capacity() * sizeof(std::uint64_t) + id2data_ind.bytesReserved();
         }
 
         void insert(IdType id, auto &&datum)
         {
             data.emplace_back(std::forward<decltype(datum)>(datum));
             data_ind2id.push_back(id);
+            data_versions.push_back(++m_version);
 
-            assert(id2data_ind.count(id) == 0);
-            id2data_ind[id] = data.size() - 1;
+            assert(!id2data_ind.contains(id));
+            id2data_ind.set(id, data.size() - 1);
         }
 
         DataType &get(IdType id)
         {
-            return data.at(id2data_ind.at(id));
+            return data[id2data_ind.at(id)];
+        }
+
+        const DataType &get(IdType id) const
+        {
+            return data[id2data_ind.at(id)];
+        }
+
+        //! position of the datum in data
+        std::size_t getDataInd(IdType id) const
+        {
+            return id2data_ind.at(id);
+        }
+
+        //! returns nullptr when there is no datum with the id
+        DataType *find(IdType id)
+        {
+            auto data_ind = id2data_ind.find(id);
+            return data_ind == PagedSparseIndex<IdType>::EMPTY ? nullptr : &data[data_ind];
         }
 
         void erase(IdType id)
         {
-            assert(id2data_ind.count(id) != 0);
+            assert(id2data_ind.contains(id));
             std::size_t data_ind = id2data_ind.at(id);
 
-            IdType swapped_id = data_ind2id.at(data.size() - 1);
+            IdType swapped_id = data_ind2id.back();
             id2data_ind.at(swapped_id) = data_ind; //! swapped points to erased
 
-            data.at(data_ind) = std::move(data.back());    //! swap
-            data.pop_back();                               //! and pop
-            data_ind2id.at(data_ind) = data_ind2id.back(); //! swap
-            data_ind2id.pop_back();                        //! and pop
+            data[data_ind] = std::move(data.back());    //! swap
+            data.pop_back();                            //! and pop
+            data_ind2id[data_ind] = data_ind2id.back(); //! swap
+            data_ind2id.pop_back();                     //! and pop
+            data_versions[data_ind] = data_versions.back();
+            data_versions.pop_back();
 
             id2data_ind.erase(id);
         }
 
+        //! exchanges places of two data in the packed arrays, ids keep pointing to their data
+        void swapData(std::size_t data_ind_a, std::size_t data_ind_b)
+        {
+            if (data_ind_a == data_ind_b)
+            {
+                return;
+            }
+            std::swap(data[data_ind_a], data[data_ind_b]);
+            std::swap(data_ind2id[data_ind_a], data_ind2id[data_ind_b]);
+            std::swap(data_versions[data_ind_a], data_versions[data_ind_b]);
+            id2data_ind.at(data_ind2id[data_ind_a]) = data_ind_a;
+            id2data_ind.at(data_ind2id[data_ind_b]) = data_ind_b;
+        }
+
+        //! call after data and data_ind2id were replaced as a whole (e.g. when restoring a snapshot)
+        //! every datum is considered changed
+        void rebuildIndex()
+        {
+            assert(data.size() == data_ind2id.size());
+            id2data_ind.clear();
+            for (std::size_t data_ind = 0; data_ind < data_ind2id.size(); ++data_ind)
+            {
+                id2data_ind.set(data_ind2id[data_ind], data_ind);
+            }
+            data_versions.assign(data.size(), ++m_version);
+        }
+
+        //! call after mutating the datum through get(), so that systems watching for changes notice it
+        void markChanged(IdType id)
+        {
+            data_versions[id2data_ind.at(id)] = ++m_version;
+        }
+
+        //! data with data_versions greater than this changed after this moment
+        std::uint64_t currentVersion() const
+        {
+            return m_version;
+        }
+
         bool isEmpty() const
         {
             return data.empty();
@@ -68,10 +276,6 @@ namespace utils
 
         void checkConsistency() const
         {
-            for (auto [entity_id, data_id] : id2data_ind)
-            {
-                assert(data_ind2id.at(data_id) == entity_id);
-            }
             for (int data_id = 0; data_id < data_ind2id.size(); ++data_id)
             {
                 assert(data_id == id2data_ind.at(data_ind2id.at(data_id)));
@@ -103,9 +307,21 @@ namespace utils
     public:
         std::vector<DataType> data;
         std::vector<IdType> data_ind2id;
+        std::vector<std::uint64_t> data_versions; //! version of the last insertion/change of each datum
 
     private:
-        std::unordered_map<IdType, std::size_t> id2data_ind;
+        PagedSparseIndex<IdType> id2data_ind;
+        std::uint64_t m_version = 0;
+    };
+
+    //! identifies an object inside of DynamicObjectPool2
+    //! the generation is bumped every time the index is removed, so handles to destroyed objects can be detected
+    struct Handle
+    {
+        int index = -1;
+        std::uint32_t generation = 0;
+
+        bool operator==(const Handle &other) const = default;
     };
 
     template <typename DataType>
@@ -126,20 +342,30 @@ namespace utils
 
         int reserveIndexForInsertion()
         {
-            int id = m_next_id;
             if (!m_free_list.empty())
             {
-                id = m_free_list.back();
+                int id = m_free_list.back();
                 m_free_list.pop_back();
+                return id;
             }
 
+            //! m_next_id is never decremented, so it can never point to a live index
+            int id = m_next_id;
             m_next_id++;
+            if (id >= m_generations.size())
+            {
+                m_generations.resize(id + 1, 0);
+            }
             return id;
         }
 
         void insertAt(int index, auto &&datum)
         {
             assert(!m_data.contains(index));
+            if (index >= m_generations.size())
+            {
+                m_generations.resize(index + 1, 0);
+            }
             m_data.insert(index, datum);
         }
 
@@ -157,16 +383,44 @@ namespace utils
             return m_data.get(index);
         }
 
+        Handle getHandle(int index) const
+        {
+            assert(contains(index));
+            return {index, m_generations[index]};
+        }
+
+        //! the handle an object inserted at a reserved index will get
+        Handle getReservedHandle(int index) const
+        {
+            assert(!contains(index) && index < m_generations.size());
+            return {index, m_generations[index]};
+        }
+
+        //! true if the handle points to an object which was not removed in the meantime
+        bool isValid(Handle handle) const
+        {
+            return handle.index >= 0 && handle.index < m_generations.size() &&
+                   m_generations[handle.index] == handle.generation &&
+                   m_data.contains(handle.index);
+        }
+
+        //! returns nullptr for stale handles
+        DataType *get(Handle handle)
+        {
+            return isValid(handle) ? &m_data.get(handle.index) : nullptr;
+        }
+
         void remove(int id)
         {
             m_data.erase(id);
+            m_generations[id]++;
             m_free_list.push_back(id);
-            m_next_id--;
         }
 
     private:
         int m_next_id = 0;
         utils::ContiguousColony<DataType, int> m_data;
+        std::vector<std::uint32_t> m_generations;
         std::vector<int> m_free_list;
     };
 
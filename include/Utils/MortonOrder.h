@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include "ContiguousColony.h"
+#include "Vector2.h"
+
+namespace utils
+{
+
+    //! spreads the lower 16 bits of x into the even bits of the result
+    inline std::uint32_t spreadBits(std::uint32_t x)
+    {
+        x &= 0x0000ffff;
+        x = (x | (x << 8)) & 0x00ff00ff;
+        x = (x | (x << 4)) & 0x0f0f0f0f;
+        x = (x | (x << 2)) & 0x33333333;
+        x = (x | (x << 1)) & 0x55555555;
+        return x;
+    }
+
+    //! position on the Z-order curve of the cell containing pos, nearby cells get nearby codes
+    inline std::uint32_t mortonCode(utils::Vector2f pos, float cell_size)
+    {
+        auto to_cell = [cell_size](float coord)
+        {
+            auto cell = static_cast<std::int64_t>(std::floor(coord / cell_size)) + (1 << 15);
+            return static_cast<std::uint32_t>(std::clamp<std::int64_t>(cell, 0, 0xffff));
+        };
+        return spreadBits(to_cell(pos.x)) | (spreadBits(to_cell(pos.y)) << 1);
+    }
+
+    //! reorders a colony by a spatial key a few elements per call, so the cost is spread over frames
+    //! the keys are computed and sorted once per pass over the colony (O(n log n) every n / max_swaps calls),
+    //! the calls in between only place the next few data, so moving entities are followed with a delay of one pass
+    class IncrementalSorter
+    {
+    public:
+        explicit IncrementalSorter(std::size_t max_swaps_per_step = 64)
+            : m_max_swaps(max_swaps_per_step)
+        {
+        }
+
+        void setMaxSwapsPerStep(std::size_t max_swaps)
+        {
+            m_max_swaps = max_swaps;
+        }
+
+        //! key_of(id) gives the sort key of the datum with the id, returns number of swapped data
+        template <class DataType, class IdType, class KeyFn>
+        std::size_t step(ContiguousColony<DataType, IdType> &colony, KeyFn &&key_of)
+        {
+            const auto n_data = colony.data.size();
+            if (n_data < 2)
+            {
+                return 0;
+            }
+
+            if (m_cursor >= m_order.size() || m_place >= n_data)
+            {
+                startPass(colony, key_of);
+            }
+
+            //! already placed data only cost a lookup, still they are bounded so that a sorted colony is cheap too
+            const std::size_t max_visited = 8 * std::max(m_max_swaps, std::size_t{1});
+            std::size_t n_swaps = 0;
+            std::size_t n_visited = 0;
+            while (n_swaps < m_max_swaps && n_visited < max_visited &&
+                   m_cursor < m_order.size() && m_place < colony.data.size())
+            {
+                auto id = static_cast<IdType>(m_order[m_cursor++]);
+                n_visited++;
+                //! the colony may have changed since the pass started
+                if (!colony.contains(id))
+                {
+                    continue;
+                }
+                auto at = colony.getDataInd(id);
+                if (at < m_place) //! moved into the placed part by an erase, it stays there until the next pass
+                {
+                    continue;
+                }
+                if (at != m_place)
+                {
+                    colony.swapData(m_place, at);
+                    n_swaps++;
+                }
+                m_place++;
+            }
+            return n_swaps;
+        }
+
+    private:
+        template <class DataType, class IdType, class KeyFn>
+        void startPass(ContiguousColony<DataType, IdType> &colony, KeyFn &key_of)
+        {
+            const auto n_data = colony.data.size();
+            m_keys.resize(n_data);
+            for (std::size_t data_ind = 0; data_ind < n_data; ++data_ind)
+            {
+                auto id = colony.data_ind2id[data_ind];
+                m_keys[data_ind] = {key_of(id), static_cast<std::int64_t>(id)};
+            }
+            std::sort(m_keys.begin(), m_keys.end());
+
+            //! ids and not positions are remembered, positions change when the colony changes during the pass
+            m_order.resize(n_data);
+            for (std::size_t i = 0; i < n_data; ++i)
+            {
+                m_order[i] = m_keys[i].second;
+            }
+            m_cursor = 0;
+            m_place = 0;
+        }
+
+    private:
+        std::vector<std::pair<std::uint32_t, std::int64_t>> m_keys;
+        std::vector<std::int64_t> m_order; //! ids in the wanted order, computed at the start of a pass
+        std::size_t m_cursor = 0;          //! next id in m_order
+        std::size_t m_place = 0;           //! where in the colony the next id goes
+        std::size_t m_max_swaps;
+    };
+
+} //! namespace utils
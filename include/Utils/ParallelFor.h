@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "ThreadPool.h"
+#include "ContiguousColony.h"
+
+namespace utils
+{
+
+    //! calls fn(id, datum) for every datum of the colony, chunks of grain data are spread over the pool
+    //! with nullptr or a disabled pool it is a plain loop on the calling thread
+    //! fn must not insert into or erase from the colony, record such changes into DeferredWrites instead
+    template <class DataType, class IdType, class Fn>
+    void parallelForEach(ThreadPool *pool, ContiguousColony<DataType, IdType> &colony, Fn &&fn, std::size_t grain = 64)
+    {
+        auto &data = colony.data;
+        auto &ids = colony.data_ind2id;
+        const auto n_data = data.size();
+        if (!pool || !pool->isEnabled() || n_data <= grain)
+        {
+            for (std::size_t data_ind = 0; data_ind < n_data; ++data_ind)
+            {
+                fn(ids[data_ind], data[data_ind]);
+            }
+            return;
+        }
+
+        grain = std::max(grain, std::size_t{1});
+        const auto n_chunks = (n_data + grain - 1) / grain;
+        pool->parallelFor(n_chunks, [&](std::size_t chunk_ind)
+                          {
+            auto last = std::min(n_data, (chunk_ind + 1) * grain);
+            for (std::size_t data_ind = chunk_ind * grain; data_ind < last; ++data_ind)
+            {
+                fn(ids[data_ind], data[data_ind]);
+            } });
+    }
+
+    //! buffers of writes recorded by tasks running in parallel, one per thread so recording needs no locking
+    //! the writes are then applied serially by flush()
+    template <class WriteType>
+    class DeferredWrites
+    {
+    public:
+        explicit DeferredWrites(std::size_t n_threads = 1)
+            : m_buffers(n_threads)
+        {
+        }
+
+        //! makes sure there is a buffer for every thread of the pool
+        void prepare(ThreadPool *pool)
+        {
+            auto n_threads = pool ? pool->participantCount() : 1;
+            if (m_buffers.size() < n_threads)
+            {
+                m_buffers.resize(n_threads);
+            }
+        }
+
+        void push(WriteType write)
+        {
+            m_buffers[ThreadPool::currentThreadIndex()].push_back(std::move(write));
+        }
+
+        //! calls apply on every write, buffers keep their memory for the next frame
+        template <class ApplyFn>
+        void flush(ApplyFn &&apply)
+        {
+            for (auto &buffer : m_buffers)
+            {
+                for (auto &write : buffer)
+                {
+                    apply(write);
+                }
+                buffer.clear();
+            }
+        }
+
+    private:
+        std::vector<std::vector<WriteType>> m_buffers;
+    };
+
+} //! namespace utils
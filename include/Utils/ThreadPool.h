@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+#if !defined(__EMSCRIPTEN__)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#endif
+
+namespace utils
+{
+
+    //! small work-stealing pool of worker threads running batches of tasks
+    //! every thread starts with its own contiguous part of the batch and when it runs out it steals half of what is left to another one
+    //! the calling thread takes part in the work, so a pool with 0 workers just runs everything inline
+    //! on the web build there are no pthreads so the pool never spawns any workers
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(std::size_t n_workers = defaultWorkerCount());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        //! calls task(i) for every i in [0, n_tasks) and returns when all of them finished
+        //! the first exception thrown by a task is rethrown in the calling thread
+        //! calls made from inside of a task (or when the pool is disabled) run inline
+        void parallelFor(std::size_t n_tasks, const std::function<void(std::size_t)> &task);
+
+        //! a disabled pool runs everything on the calling thread
+        void setEnabled(bool enabled);
+        bool isEnabled() const;
+
+        std::size_t workerCount() const;
+        //! number of threads which can run tasks of one batch (workers + the caller)
+        std::size_t participantCount() const;
+
+        //! 0 for threads not owned by a pool, i+1 for the i-th worker, usable to index per thread buffers
+        static std::size_t currentThreadIndex();
+
+        static std::size_t defaultWorkerCount();
+
+    private:
+        bool m_enabled = true;
+
+#if !defined(__EMSCRIPTEN__)
+        //! part of the batch owned by one thread, guarded by its own mutex so stealing does not block the others
+        struct alignas(64) WorkRange
+        {
+            std::mutex mutex;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+        };
+
+        void workerLoop(std::size_t thread_ind);
+        void runTasks(const std::function<void(std::size_t)> &task, std::size_t thread_ind);
+        bool popTask(std::size_t thread_ind, std::size_t &task_ind);
+        bool stealTask(std::size_t thread_ind, std::size_t &task_ind);
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::vector<std::unique_ptr<WorkRange>> m_ranges; //! one per participant, 0 is the caller
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake_workers;
+        std::condition_variable m_batch_done;
+
+        const std::function<void(std::size_t)> *p_task = nullptr;
+        std::size_t m_task_count = 0;
+        std::size_t m_finished_count = 0;
+        std::size_t m_active_workers = 0;
+        std::size_t m_batch_id = 0;
+        std::exception_ptr m_exception;
+        bool m_stopping = false;
+#endif
+    };
+
+} //! namespace utils
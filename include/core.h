@@ -2,6 +2,12 @@
 
 #include <cmath>
 #include <cassert>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include <Utils/Vector2.h>
 
@@ -88,7 +94,7 @@ float inline calcOverlap(const Projection1D &p1, const Projection1D &p2)
   return std::min(p1.max, p2.max) - std::max(p1.min, p2.min);
 }
 
-Projection1D inline projectOnAxis(utils::Vector2f t, const std::vector<utils::Vector2f> &points)
+Projection1D inline projectOnAxis(utils::Vector2f t, std::span<const utils::Vector2f> points)
 {
 
   Projection1D projection;
@@ -100,3 +106,37 @@ Projection1D inline projectOnAxis(utils::Vector2f t, const std::vector<utils::Ve
   }
   return projection;
 }
+
+//! projects the points onto four axes at once, the axes are given as xs and ys (SoA)
+//! every vertex is broadcast into all lanes, so one instruction works on four axes and no lanes need to be combined
+//! the results are the same as of projectOnAxis for each of the axes
+void inline projectOnAxes4(const float *axes_x, const float *axes_y, std::span<const utils::Vector2f> points,
+                           float *mins, float *maxs)
+{
+#if defined(__SSE2__)
+  const __m128 tx = _mm_loadu_ps(axes_x);
+  const __m128 ty = _mm_loadu_ps(axes_y);
+  __m128 lane_mins = _mm_set1_ps(Projection1D{}.min);
+  __m128 lane_maxs = _mm_set1_ps(Projection1D{}.max);
+  for (auto &point : points)
+  {
+    __m128 proj = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(point.x), tx), _mm_mul_ps(_mm_set1_ps(point.y), ty));
+    lane_mins = _mm_min_ps(lane_mins, proj);
+    lane_maxs = _mm_max_ps(lane_maxs, proj);
+  }
+  _mm_storeu_ps(mins, lane_mins);
+  _mm_storeu_ps(maxs, lane_maxs);
+#else
+  for (int lane = 0; lane < 4; ++lane)
+  {
+    auto projection = projectOnAxis({axes_x[lane], axes_y[lane]}, points);
+    mins[lane] = projection.min;
+    maxs[lane] = projection.max;
+  }
+#endif
+}
+
+Projection1D inline projectOnAxis(utils::Vector2f t, const std::vector<utils::Vector2f> &points)
+{
+  return projectOnAxis(t, std::span<const utils::Vector2f>(points));
+}
@@ -5,6 +5,7 @@
 
 #include "TextureAtlas.h"
 #include "IOUtils.h"
+#include "Utils/ParallelFor.h"
 
 AnimationSystem::AnimationSystem(utils::ContiguousColony<AnimationComponent, int> &comps, std::filesystem::path animations_texture_dir, std::filesystem::path animations_data_dir)
     : m_components(comps), m_animations_data_dir(animations_data_dir)
@@ -54,8 +55,9 @@ void AnimationSystem::registerAnimation(TextureAtlas &atlas, const std::string &
 
 void AnimationSystem::update(float dt)
 {
-    for (auto &comp : m_components.data)
-    {
+    //! frame data are only read here so the animations can be advanced in parallel
+    utils::parallelForEach(p_pool, m_components, [&](int id, AnimationComponent &comp)
+                           {
         comp.tex_rect = m_frame_data.at(comp.id).tex_rects.at(comp.current_frame_id);
         comp.texture_size = m_frame_data.at(comp.id).p_texture->getSize();
         comp.time += dt;
@@ -68,8 +70,7 @@ void AnimationSystem::update(float dt)
             {
                 comp.n_repeats_left--;
             }
-        }
-    }
+        } });
 }
 
 Rect<int> AnimationSystem::getNextFrame(AnimationComponent &comp)
@@ -10,6 +10,9 @@
 
 #include <Shader.h>
 
+#include <cmath>
+#include <cassert>
+
 #include "Utils/IOUtils.h"
 
 #include "Games/JumpGame.h"
@@ -114,13 +117,28 @@ void Application::run()
 #endif
 }
 
-void Application::iterate()
+void Application::setSimulationRate(int ticks_per_second)
 {
+    assert(ticks_per_second > 0);
+    m_fixed_dt = 1.f / ticks_per_second;
+    m_accumulator = 0.f;
+}
 
-    if (m_screen_stack.size() > 0)
+void Application::iterate()
+{
+    m_accumulator += m_dt;
+    int step_count = 0;
+    while (m_accumulator >= m_fixed_dt && step_count < MAX_SUBSTEPS)
     {
-        m_screen_stack.back()->update(m_dt);
+        if (m_screen_stack.size() > 0)
+        {
+            m_screen_stack.back()->update(m_fixed_dt);
+        }
+        m_accumulator -= m_fixed_dt;
+        step_count++;
     }
+    //! if the steps ran out we are too slow, rather lose the time than get into a spiral of ever longer frames
+    m_accumulator = std::fmod(m_accumulator, m_fixed_dt);
 
     //! poll and events let state stack handle them
     SDL_Event event;
@@ -191,8 +209,11 @@ void Application::iterate()
     }
     m_window_canvas.clear({0, 0, 0, 1});
 
+    //! only the top screen is updated, the others stay where they were
+    float alpha = m_accumulator / m_fixed_dt;
     for (auto &screen : m_screen_stack)
     {
+        screen->setRenderInterpolation(screen == m_screen_stack.back() ? alpha : 1.f);
         screen->draw(m_window_canvas);
     }
 
@@ -2,16 +2,57 @@
 #include "GameObject.h"
 
 #include "Systems/System.h"
+#include "Utils/ThreadPool.h"
+#include "Utils/ColonyView.h"
+
+#include <algorithm>
+
+void CollisionShape::updateWorldGeometry()
+{
+    //! the buffers keep their capacity so this does not allocate once the shape is set up
+    world_offsets.resize(convex_shapes.size() + 1);
+    std::size_t total_count = 0;
+    for (std::size_t i = 0; i < convex_shapes.size(); ++i)
+    {
+        world_offsets[i] = total_count;
+        total_count += convex_shapes[i].points.size();
+    }
+    world_offsets.back() = total_count;
+    world_points.resize(total_count);
+    world_normals.resize(total_count);
+
+    for (std::size_t i = 0; i < convex_shapes.size(); ++i)
+    {
+        auto begin = world_offsets[i];
+        auto count = world_offsets[i + 1] - begin;
+        auto points = std::span(world_points).subspan(begin, count);
+        convex_shapes[i].writePointsInWorld(points);
+        Collisions::computeEdgeNormals(points, std::span(world_normals).subspan(begin, count));
+    }
+}
 
 namespace Collisions
 {
 
     std::vector<std::tuple<GameObject *, GameObject *, CollisionData>> collisions; //! for debugging
 
-    CollisionSystem::CollisionSystem(PostOffice &messenger, utils::ContiguousColony<CollisionComponent, int> &comps)
-        : p_post_office(&messenger), m_components(comps)
+    void computeEdgeNormals(std::span<const utils::Vector2f> points, std::span<utils::Vector2f> normals)
     {
-        messenger.registerEvents<CollisionEventEntities, CollisionEventTypeEntity, CollisionEventTypes>();
+        assert(points.size() == normals.size());
+        const auto n_points = points.size();
+        for (std::size_t curr = 0; curr < n_points; ++curr)
+        {
+            auto t = points[(curr + 1) % n_points] - points[curr];
+            utils::Vector2f n = {t.y, -t.x}; //! line perpendicular to the edge
+            normals[curr] = utils::approx_equal_zero(norm2(n)) ? utils::Vector2f{0, 0} : n / norm(n);
+        }
+    }
+
+    CollisionSystem::CollisionSystem(PostOffice &messenger, utils::ContiguousColony<CollisionComponent, int> &comps, TransformStore &transforms)
+        : p_post_office(&messenger), m_components(comps), m_transforms(transforms)
+    {
+        messenger.registerEvents<CollisionEventEntities, CollisionEventTypeEntity, CollisionEventTypes,
+                                 CollisionEnterEvent, CollisionExitEvent>();
         //! init the trees
         for (int i = 0; i < static_cast<int>(ObjectType::Count); ++i)
         {
@@ -21,51 +62,153 @@ namespace Collisions
 
     void CollisionSystem::insertObject(GameObject &object)
     {
-        auto bounding_rect = m_components.get(object.getId()).shape.getBoundingRect().inflate(1.5f);
+        auto &shape = m_components.get(object.getId()).shape;
+        shape.updateWorldGeometry(); //! so that queries work before the next preUpdate
+        auto bounding_rect = makeFatRect(shape.getBoundingRect(), object.m_vel * m_last_dt);
         m_object_type2tree[object.getType()].addRect(bounding_rect, object.getId());
     }
 
+    AABB CollisionSystem::makeFatRect(AABB fitting_rect, utils::Vector2f displacement) const
+    {
+        fitting_rect.inflate(FAT_RECT_SCALE);
+        //! the rect is stretched only in the direction of motion, that is where the object will be in the next frames
+        auto stretch = displacement * m_displacement_multiplier;
+        (stretch.x > 0.f ? fitting_rect.r_max.x : fitting_rect.r_min.x) += stretch.x;
+        (stretch.y > 0.f ? fitting_rect.r_max.y : fitting_rect.r_min.y) += stretch.y;
+        return fitting_rect;
+    }
+
+    void CollisionSystem::setDisplacementMultiplier(float multiplier)
+    {
+        m_displacement_multiplier = multiplier;
+    }
+
+    std::size_t CollisionSystem::getReinsertionCount() const
+    {
+        return m_reinsertion_count;
+    }
+
+    std::size_t CollisionSystem::getTotalReinsertionCount() const
+    {
+        return m_total_reinsertion_count;
+    }
+
     void CollisionSystem::removeObject(GameObject &object)
     {
         m_object_type2tree.at(object.getType()).removeObject(object.getId());
+
+        //! the id may be reused by a new object, so its pairs cannot wait until they go stale
+        const auto id = object.getId();
+        if (m_in_narrow_phase)
+        {
+            //! called from a resolver, the narrow phase still points into m_contacts
+            m_removed_in_narrow_phase.push_back(id);
+            return;
+        }
+        eraseContactsOf(id);
+    }
+
+    void CollisionSystem::eraseContactsOf(int id)
+    {
+        std::erase_if(m_contacts, [this, id](const auto &key_and_contact)
+                      {
+            auto &[key, contact] = key_and_contact;
+            if (key.first != id && key.second != id)
+            {
+                return false;
+            }
+            if (contact.touching)
+            {
+                p_post_office->send(CollisionExitEvent{key.first, key.second});
+            }
+            return true; });
+    }
+
+    bool CollisionSystem::hasMoved(int entity_id) const
+    {
+        return entity_id < static_cast<int>(m_moved.size()) && m_moved[entity_id];
+    }
+
+    const CollisionData *CollisionSystem::findContact(int id_a, int id_b) const
+    {
+        auto contact_it = m_contacts.find({id_a, id_b});
+        if (contact_it == m_contacts.end())
+        {
+            contact_it = m_contacts.find({id_b, id_a});
+        }
+        if (contact_it == m_contacts.end() || !contact_it->second.touching)
+        {
+            return nullptr;
+        }
+        return &contact_it->second.manifold;
+    }
+
+    void CollisionSystem::setSpatialSorting(bool enabled, std::size_t swaps_per_frame, float cell_size)
+    {
+        m_spatial_sorting = enabled;
+        m_sorter.setMaxSwapsPerStep(swaps_per_frame);
+        m_sorting_cell_size = cell_size;
     }
 
     void CollisionSystem::preUpdate(float dt, EntityRegistryT &entities)
     {
+        //! done first, the rest of the update works with positions in the colony
+        if (m_spatial_sorting)
+        {
+            m_sorter.step(m_components, [this](int id)
+                          { return utils::mortonCode(m_transforms.worldPosition(id), m_sorting_cell_size); });
+        }
+
+        m_tick++;
+        m_last_dt = dt;
+        m_reinsertion_count = 0;
+        std::fill(m_moved.begin(), m_moved.end(), false);
 
         auto &comps = m_components.data;
-        auto &comp_ids = m_components.data_ind2id;
-        for (std::size_t comp_id = 0; comp_id < comps.size(); ++comp_id)
+        auto &comp_versions = m_components.data_versions;
+        for (auto [id, comp] : utils::ColonyView(m_components))
         {
-            auto &comp = comps[comp_id];
+            //! only shapes of entities which moved (or were just added) need refreshing, static walls are skipped
+            if (comp_versions[&comp - comps.data()] <= m_seen_components_version &&
+                !m_transforms.changedSince(id, m_seen_transforms_version))
+            {
+                continue;
+            }
+            if (id >= static_cast<int>(m_moved.size()))
+            {
+                m_moved.resize(id + 1, false);
+            }
+            m_moved[id] = true;
+
+            const auto pos = m_transforms.worldPosition(id);
+            const auto scale = m_transforms.size(id) / 2.f;
+            const auto angle = m_transforms.worldAngle(id);
             for (auto &shape : comp.shape.convex_shapes)
             {
-                shape.setPosition(entities.at(comp_ids.at(comp_id))->getPosition());
-                shape.setScale(entities.at(comp_ids.at(comp_id))->getSize() / 2.);
-                shape.setRotation(entities.at(comp_ids.at(comp_id))->getAngle());
+                shape.setPosition(pos);
+                shape.setScale(scale);
+                shape.setRotation(angle);
             }
-        }
+            comp.shape.updateWorldGeometry();
 
-        for (std::size_t comp_id = 0; comp_id < comps.size(); ++comp_id)
-        {
             //! update the tree if the entity moved outside of it's BoundingBox
-            // auto& entity
-            auto &comp = comps[comp_id];
             auto &tree = m_object_type2tree.at(comp.type);
-            auto entity_ind = comp_ids.at(comp_id);
-
             auto fitting_rect = comp.shape.getBoundingRect();
-            auto big_bounding_rect = tree.getObjectRect(entity_ind);
+            auto big_bounding_rect = tree.getObjectRect(id);
 
             //! if object moved in a way that rect in the collision tree does not fully contain it
             if (makeUnion(fitting_rect, big_bounding_rect).volume() > big_bounding_rect.volume())
             {
-                tree.removeObject(entity_ind);
-                tree.addRect(fitting_rect.inflate(1.5f), entity_ind);
+                tree.removeObject(id);
+                tree.addRect(makeFatRect(fitting_rect, entities.at(id)->m_vel * dt), id);
+                m_reinsertion_count++;
+                m_total_reinsertion_count++;
             }
         }
+        m_seen_components_version = m_components.currentVersion();
+        m_seen_transforms_version = m_transforms.currentVersion();
 
-        for (auto &[type_pair, callback] : m_registered_resolvers)
+        for (auto &[type_pair, resolver] : m_registered_resolvers)
         {
             auto &[type_a, type_b] = type_pair;
             auto &tree_a = m_object_type2tree.at((ObjectType)type_a);
@@ -81,64 +224,182 @@ namespace Collisions
                 close_pairs = tree_a.findClosePairsWith2(tree_b);
             }
 
-            narrowPhase2(close_pairs, entities, callback);
+            narrowPhase2(close_pairs, entities, resolver, type_a == type_b);
         }
+        removeStaleContacts();
 
+#ifndef NDEBUG
         m_collided2.clear();
+#endif
     }
 
-    void CollisionSystem::shapesCollide(const std::vector<Polygon>& shape1, const std::vector<Polygon>& shape2,
-                    GameObject& obj1, GameObject& obj2, CollisionCallbackT &callback)
+    CollisionData CollisionSystem::shapesCollide(const CollisionShape &shape1, const CollisionShape &shape2) const
     {
-        for (auto &sub_shape1 : shape1)
+        for (std::size_t i1 = 0; i1 < shape1.convex_shapes.size(); ++i1)
         {
-            for (auto &sub_shape2 : shape2)
+            for (std::size_t i2 = 0; i2 < shape2.convex_shapes.size(); ++i2)
             {
-
-                CollisionData collision_data = getCollisionData(sub_shape1, sub_shape2);
-
+                CollisionData collision_data = getCollisionData(shape1.getWorldPolygon(i1), shape2.getWorldPolygon(i2));
                 if (collision_data.minimum_translation > 0) //! there is a collision
                 {
-
-                    collisions.push_back({&obj1, &obj2, collision_data});
-
-                    p_post_office->send(CollisionEvent{obj1.getId(), obj2.getId()});
-                    callback(obj1, obj2, collision_data);
                     //! Fuck this shit, do not collide with multiple subshapes?
-                    return;
+                    return collision_data;
                 }
             }
         }
+        return {};
     }
+
     void CollisionSystem::narrowPhase2(const std::vector<std::pair<int, int>> &colliding_pairs,
-                                       EntityRegistryT &entities, CollisionCallbackT &callback)
+                                       EntityRegistryT &entities, Resolver &resolver, bool same_types)
     {
-        for (auto [i1, i2] : colliding_pairs)
+        //! the cache is only looked up here, so the workers below do not touch the map
+        m_pair_contacts.clear();
+        m_pairs_to_compute.clear();
+        for (std::size_t pair_ind = 0; pair_ind < colliding_pairs.size(); ++pair_ind)
+        {
+            auto [i1, i2] = colliding_pairs[pair_ind];
+            assert(i1 != i2); //! no self collisions
+#ifndef NDEBUG
+            assert(m_collided2.count({i1, i2}) == 0); //! evaluate each collision once
+            m_collided2.insert({i1, i2});
+#endif
+
+            //! the broad phase does not keep the order within pairs of the same type
+            auto key = same_types && i2 < i1 ? std::pair{i2, i1} : std::pair{i1, i2};
+            auto [contact_it, is_new] = m_contacts.try_emplace(key);
+            auto &contact = contact_it->second;
+            m_pair_contacts.push_back({&contact, contact.touching});
+            contact.last_tick = m_tick;
+
+            //! if neither shape moved the last manifold is still valid
+            if (is_new || contact.first_id != i1 || hasMoved(i1) || hasMoved(i2))
+            {
+                contact.first_id = i1;
+                m_pairs_to_compute.push_back(pair_ind);
+            }
+        }
+
+        computeManifolds(colliding_pairs);
+
+        //! messages and callbacks go out only from here, in the order of the pairs, so they do not depend on the threads
+        //! resolvers may remove objects, their contacts are erased only after the loop so that m_pair_contacts stays valid
+        m_in_narrow_phase = true;
+        for (std::size_t pair_ind = 0; pair_ind < colliding_pairs.size(); ++pair_ind)
         {
-            assert(i1 != i2 && m_collided2.count({i1, i2}) == 0); //! no self collisions and evaluate each collision once
+            auto [i1, i2] = colliding_pairs[pair_ind];
+            if (wasRemovedInNarrowPhase(i1) || wasRemovedInNarrowPhase(i2))
+            {
+                continue;
+            }
+            auto [p_contact, was_touching] = m_pair_contacts[pair_ind];
+            auto &contact = *p_contact;
+
+            if (!contact.touching)
+            {
+                if (was_touching)
+                {
+                    p_post_office->send(CollisionExitEvent{i1, i2});
+                }
+                continue;
+            }
+            if (!was_touching)
+            {
+                p_post_office->send(CollisionEnterEvent{i1, i2});
+            }
+            if (resolver.mode == ContactMode::OnEnter && was_touching)
+            {
+                continue;
+            }
 
             auto &obj1 = *entities.at(i1);
             auto &obj2 = *entities.at(i2);
-            m_collided2.insert({i1, i2});
+            collisions.push_back({&obj1, &obj2, contact.manifold});
+            obj1.wake();
+            obj2.wake();
+            resolver.callback(obj1, obj2, contact.manifold);
+        }
+        m_in_narrow_phase = false;
 
-            auto &shape1 = m_components.get(i1).shape.convex_shapes;
-            auto &shape2 = m_components.get(i2).shape.convex_shapes;
-            shapesCollide(shape1, shape2, obj1, obj2, callback);
+        for (auto id : m_removed_in_narrow_phase)
+        {
+            eraseContactsOf(id);
+        }
+        m_removed_in_narrow_phase.clear();
+    }
+
+    bool CollisionSystem::wasRemovedInNarrowPhase(int id) const
+    {
+        return std::find(m_removed_in_narrow_phase.begin(), m_removed_in_narrow_phase.end(), id) != m_removed_in_narrow_phase.end();
+    }
+
+    void CollisionSystem::computeManifolds(const std::vector<std::pair<int, int>> &colliding_pairs)
+    {
+        //! every pair writes only its own contact, so the result does not depend on which thread computed it
+        //! the workers only read the components, resolvers, events and m_contacts are left to the calling thread
+        const auto &components = m_components;
+        auto compute = [&](std::size_t job_ind)
+        {
+            auto pair_ind = m_pairs_to_compute[job_ind];
+            auto [i1, i2] = colliding_pairs[pair_ind];
+            auto &contact = *m_pair_contacts[pair_ind].p_contact;
+            contact.manifold = shapesCollide(components.get(i1).shape, components.get(i2).shape);
+            contact.touching = contact.manifold.minimum_translation > 0;
+        };
+
+        const auto n_jobs = m_pairs_to_compute.size();
+        if (!p_pool || !p_pool->isEnabled() || n_jobs <= NARROW_PHASE_GRAIN)
+        {
+            for (std::size_t job_ind = 0; job_ind < n_jobs; ++job_ind)
+            {
+                compute(job_ind);
+            }
+            return;
         }
+
+        const auto n_chunks = (n_jobs + NARROW_PHASE_GRAIN - 1) / NARROW_PHASE_GRAIN;
+        p_pool->parallelFor(n_chunks, [&](std::size_t chunk_ind)
+                            {
+            auto last = std::min(n_jobs, (chunk_ind + 1) * NARROW_PHASE_GRAIN);
+            for (std::size_t job_ind = chunk_ind * NARROW_PHASE_GRAIN; job_ind < last; ++job_ind)
+            {
+                compute(job_ind);
+            } });
+    }
+
+    void CollisionSystem::clearContacts()
+    {
+        m_contacts.clear();
+        std::fill(m_moved.begin(), m_moved.end(), false);
+    }
+
+    void CollisionSystem::removeStaleContacts()
+    {
+        //! pairs which the broad phase did not find in this tick are too far apart to touch
+        std::erase_if(m_contacts, [this](const auto &key_and_contact)
+                      {
+            auto &[key, contact] = key_and_contact;
+            if (contact.last_tick == m_tick)
+            {
+                return false;
+            }
+            if (contact.touching)
+            {
+                p_post_office->send(CollisionExitEvent{key.first, key.second});
+            }
+            return true; });
     }
 
-    CollisionData CollisionSystem::getCollisionData(const Polygon &pa, const Polygon &pb) const
+    CollisionData CollisionSystem::getCollisionData(const WorldPolygon &pa, const WorldPolygon &pb) const
     {
-        auto points_a = pa.getPointsInWorld();
-        auto points_b = pb.getPointsInWorld();
-        auto c_data = calcCollisionData(points_a, points_b);
+        auto c_data = calcCollisionData(pa.points, pa.normals, pb.points, pb.normals);
 
         if (c_data.minimum_translation < 0.f)
         {
             return c_data; //! there is no collision so we don't need to extract manifold
         }
-        auto center_a = pa.getPosition();
-        auto center_b = pb.getPosition();
+        auto center_a = pa.center;
+        auto center_b = pb.center;
         //! make separation axis point always from a to b
         auto are_flipped = dot((center_a - center_b), c_data.separation_axis) > 0;
         if (are_flipped)
@@ -146,20 +407,20 @@ namespace Collisions
             c_data.separation_axis *= -1.f;
         }
 
-        auto col_feats1 = obtainFeatures(c_data.separation_axis, points_a);
-        auto col_feats2 = obtainFeatures(-1.f * c_data.separation_axis, points_b);
+        auto col_feats1 = obtainFeatures(c_data.separation_axis, pa.points);
+        auto col_feats2 = obtainFeatures(-1.f * c_data.separation_axis, pb.points);
 
         auto clipped_edge = clipEdges(col_feats1, col_feats2, c_data.separation_axis);
-        if (clipped_edge.size() == 0) //! clipping failed so we don't do collision
+        if (clipped_edge.count == 0) //! clipping failed so we don't do collision
         {
             c_data.minimum_translation = -1.f;
             return c_data;
         }
-        for (auto ce : clipped_edge)
+        for (int i = 0; i < clipped_edge.count; ++i)
         {
-            c_data.contact_point += ce;
+            c_data.contact_point += clipped_edge.points[i];
         }
-        c_data.contact_point /= (float)clipped_edge.size();
+        c_data.contact_point /= (float)clipped_edge.count;
 
         return c_data;
     }
@@ -176,16 +437,18 @@ namespace Collisions
     {
         auto nearest_inds = m_object_type2tree.at(type).findIntersectingLeaves(collision_body.getBoundingRect());
         auto points = collision_body.getPointsInWorld();
+        std::vector<utils::Vector2f> normals(points.size());
+        computeEdgeNormals(points, normals);
 
         std::vector<CollisionComponent *> collision_ids;
         for (auto ind : nearest_inds)
         {
             auto &collision_comp = m_components.get(ind);
 
-            for (auto &shape : collision_comp.shape.convex_shapes)
+            for (std::size_t shape_ind = 0; shape_ind < collision_comp.shape.convex_shapes.size(); ++shape_ind)
             {
-                auto points_other = shape.getPointsInWorld();
-                auto c_data = calcCollisionData(points, points_other);
+                auto other = collision_comp.shape.getWorldPolygon(shape_ind);
+                auto c_data = calcCollisionData(points, normals, other.points, other.normals);
                 if (c_data.minimum_translation > 0.)
                 {
                     collision_ids.push_back(&collision_comp);
@@ -222,14 +485,14 @@ namespace Collisions
         for (auto ent_ind : inters)
         {
             auto &comp = m_components.get(ent_ind);
-            for (auto &shape : comp.shape.convex_shapes)
+            for (std::size_t shape_ind = 0; shape_ind < comp.shape.convex_shapes.size(); ++shape_ind)
             {
-                auto points = shape.getPointsInWorld();
+                auto points = comp.shape.getWorldPolygon(shape_ind).points;
                 int next = 1;
                 for (int i = 0; i < points.size(); ++i)
                 {
-                    utils::Vector2f r1 = points.at(i);
-                    utils::Vector2f r2 = points.at(next);
+                    utils::Vector2f r1 = points[i];
+                    utils::Vector2f r2 = points[next];
 
                     utils::Vector2f segment_intersection;
                     if (utils::segmentsIntersect(r1, r2, at, at + dir * length, segment_intersection))
@@ -252,78 +515,40 @@ namespace Collisions
         return closest_intersection;
     }
 
-    CollisionData inline calcCollisionData(const std::vector<utils::Vector2f> &points1,
-                                           const std::vector<utils::Vector2f> &points2)
+    //! checks the axes of one polygon, returns false if one of them separates the polygons
+    //! the axes are projected in batches of four, then checked one by one in their order
+    bool inline findMinOverlap(std::span<const utils::Vector2f> axes,
+                               std::span<const utils::Vector2f> points1, std::span<const utils::Vector2f> points2,
+                               bool axes_belong_to_a, float &min_overlap, CollisionData &collision_result)
     {
-        CollisionData collision_result;
-
-        int next = 1;
-        const auto n_points1 = points1.size();
-        const auto n_points2 = points2.size();
-
-        Edge contact_edge;
-
-        float min_overlap = std::numeric_limits<float>::max();
-        utils::Vector2f &min_axis = collision_result.separation_axis;
-        for (int curr = 0; curr < n_points1; ++curr)
+        for (std::size_t first = 0; first < axes.size(); first += 4)
         {
-
-            auto t1 = points1[next] - points1[curr]; //! line perpendicular to current polygon edge
-            utils::Vector2f n1 = {t1.y, -t1.x};
-            if (utils::approx_equal_zero(norm2(n1)))
+            const auto n_axes = std::min(axes.size() - first, std::size_t{4});
+            float axes_x[4] = {};
+            float axes_y[4] = {};
+            for (std::size_t lane = 0; lane < n_axes; ++lane)
             {
-                continue;
+                axes_x[lane] = axes[first + lane].x;
+                axes_y[lane] = axes[first + lane].y;
             }
-            n1 /= norm(n1);
-            auto proj1 = projectOnAxis(n1, points1);
-            auto proj2 = projectOnAxis(n1, points2);
+            float mins1[4], maxs1[4], mins2[4], maxs2[4];
+            projectOnAxes4(axes_x, axes_y, points1, mins1, maxs1);
+            projectOnAxes4(axes_x, axes_y, points2, mins2, maxs2);
 
-            if (!overlap1D(proj1, proj2))
-            {
-                collision_result.minimum_translation = -1;
-                return collision_result;
-            }
-            else
+            for (std::size_t lane = 0; lane < n_axes; ++lane)
             {
-                auto overlap = calcOverlap(proj1, proj2);
-                if (utils::approx_equal_zero(overlap))
+                auto n = axes[first + lane];
+                if (n.x == 0.f && n.y == 0.f) //! degenerate edge
                 {
                     continue;
                 }
-                if (overlap < min_overlap)
+                Projection1D proj1 = {mins1[lane], maxs1[lane]};
+                Projection1D proj2 = {mins2[lane], maxs2[lane]};
+
+                if (!overlap1D(proj1, proj2))
                 {
-                    min_overlap = overlap;
-                    min_axis = n1;
+                    return false;
                 }
-            }
-
-            next++;
-            if (next == n_points1)
-            {
-                next = 0;
-            }
-        }
-        next = 1;
-        for (int curr = 0; curr < n_points2; ++curr)
-        {
-
-            auto t1 = points2[next] - points2[curr]; //! line perpendicular to current polygon edge
-            utils::Vector2f n1 = {t1.y, -t1.x};
-            if (utils::approx_equal_zero(norm2(n1)))
-            {
-                continue;
-            }
-            n1 /= norm(n1);
-            auto proj2 = projectOnAxis(n1, points2);
-            auto proj1 = projectOnAxis(n1, points1);
-
-            if (!overlap1D(proj1, proj2))
-            {
-                collision_result.minimum_translation = -1;
-                return collision_result;
-            }
-            else
-            {
                 auto overlap = calcOverlap(proj1, proj2);
                 if (utils::approx_equal_zero(overlap))
                 {
@@ -332,23 +557,32 @@ namespace Collisions
                 if (overlap < min_overlap)
                 {
                     min_overlap = overlap;
-                    min_axis = n1;
-                    collision_result.belongs_to_a = false;
+                    collision_result.separation_axis = n;
+                    collision_result.belongs_to_a = axes_belong_to_a;
                 }
             }
+        }
+        return true;
+    }
 
-            next++;
-            if (next == n_points2)
-            {
-                next = 0;
-            }
+    CollisionData calcCollisionData(std::span<const utils::Vector2f> points1, std::span<const utils::Vector2f> normals1,
+                                    std::span<const utils::Vector2f> points2, std::span<const utils::Vector2f> normals2)
+    {
+        CollisionData collision_result;
+
+        float min_overlap = std::numeric_limits<float>::max();
+        if (!findMinOverlap(normals1, points1, points2, true, min_overlap, collision_result) ||
+            !findMinOverlap(normals2, points1, points2, false, min_overlap, collision_result))
+        {
+            collision_result.minimum_translation = -1;
+            return collision_result;
         }
 
         collision_result.minimum_translation = min_overlap;
         return collision_result;
     }
 
-    int inline furthestVertex(utils::Vector2f separation_axis, const std::vector<utils::Vector2f> &points)
+    int inline furthestVertex(utils::Vector2f separation_axis, std::span<const utils::Vector2f> points)
     {
         float max_dist = -std::numeric_limits<float>::max();
         int index = -1;
@@ -365,7 +599,7 @@ namespace Collisions
         return index;
     }
 
-    CollisionFeature inline obtainFeatures(const utils::Vector2f axis, const std::vector<utils::Vector2f> &points)
+    CollisionFeature inline obtainFeatures(const utils::Vector2f axis, std::span<const utils::Vector2f> points)
     {
 
         const auto n_points = points.size();
@@ -392,19 +626,19 @@ namespace Collisions
         return feature;
     }
 
-    std::vector<utils::Vector2f> inline clip(utils::Vector2f v1, utils::Vector2f v2, utils::Vector2f n, float overlap)
+    ClippedPoints inline clip(utils::Vector2f v1, utils::Vector2f v2, utils::Vector2f n, float overlap)
     {
 
-        std::vector<utils::Vector2f> cp;
+        ClippedPoints cp;
         float d1 = dot(v1, n) - overlap;
         float d2 = dot(v2, n) - overlap;
         if (d1 >= 0.0)
         {
-            cp.push_back(v1);
+            cp.push(v1);
         }
         if (d2 >= 0.0)
         {
-            cp.push_back(v2);
+            cp.push(v2);
         }
         if (d1 * d2 < 0.0)
         {
@@ -414,12 +648,12 @@ namespace Collisions
             float u = d1 / (d1 - d2);
             e *= u;
             e += v1;
-            cp.push_back(e);
+            cp.push(e);
         }
         return cp;
     }
 
-    std::vector<utils::Vector2f> inline clipEdges(CollisionFeature &ref_features, CollisionFeature &inc_features, utils::Vector2f n)
+    ClippedPoints inline clipEdges(CollisionFeature &ref_features, CollisionFeature &inc_features, utils::Vector2f n)
     {
 
         auto &ref_edge = ref_features.edge;
@@ -441,17 +675,16 @@ namespace Collisions
         // clip the incident edge by the first
         // vertex of the reference edge
         auto cp = clip(inc_edge.from, inc_edge.to(), ref_v, o1);
-        auto cp_new = cp;
         // if we dont have 2 points left then fail
-        if (cp.size() < 2)
+        if (cp.count < 2)
         {
             return {};
         }
 
         double o2 = dot(ref_v, ref_edge.to());
-        cp = clip(cp[0], cp[1], -ref_v, -o2);
+        cp = clip(cp.points[0], cp.points[1], -ref_v, -o2);
         // if we dont have 2 points left then fail
-        if (cp.size() < 2)
+        if (cp.count < 2)
         {
             return {};
         }
@@ -463,19 +696,15 @@ namespace Collisions
         double max = dot(refNorm, ref_features.best_vertex);
         // make sure the final points are not past this maximum
 
-        std::vector<float> depths(2);
-        depths[0] = dot(refNorm, cp.at(0)) - max;
-        depths[1] = dot(refNorm, cp.at(1)) - max;
-
-        if (depths[0] < 0.0f)
+        ClippedPoints result;
+        for (int i = 0; i < cp.count; ++i)
         {
-            cp.erase(cp.begin());
-        }
-        if (depths[1] < 0.0f)
-        {
-            cp.pop_back();
+            if (dot(refNorm, cp.points[i]) - max >= 0.0f)
+            {
+                result.push(cp.points[i]);
+            }
         }
-        return cp;
+        return result;
     }
 
     void bounce(GameObject &obj1, GameObject &obj2, CollisionData c_data)
@@ -528,9 +757,9 @@ namespace Collisions
     void CollisionSystem::draw(Renderer &canvas)
     {
 
-        for (std::size_t comp_id = 0; comp_id < m_components.data.size(); comp_id++)
+        for (auto [id, comp] : utils::ColonyView(m_components))
         {
-            drawComponent(m_components.data[comp_id], canvas);
+            drawComponent(comp, canvas);
         }
 
         //! draw physics collisions
@@ -545,7 +774,7 @@ namespace Collisions
         collisions.clear();
     }
 
-    void CollisionSystem::registerResolver(ObjectType type_a, ObjectType type_b, CollisionCallbackT callback)
+    void CollisionSystem::registerResolver(ObjectType type_a, ObjectType type_b, CollisionCallbackT callback, ContactMode mode)
     {
         if (!callback)
         {
@@ -559,7 +788,7 @@ namespace Collisions
             };
         }
 
-        m_registered_resolvers.insert({{(int)type_a, (int)type_b}, callback});
+        m_registered_resolvers.insert({{(int)type_a, (int)type_b}, {callback, mode}});
     }
 
 } //! namespace collisions
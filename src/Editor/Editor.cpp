@@ -940,8 +940,8 @@ void Editor::registerSystems()
     auto &systems = m_design_world->m_systems;
 
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
-    systems.registerSystem(std::make_shared<PathSystem>(systems.getComponents<PathComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
+    systems.registerSystem(std::make_shared<PathSystem>(systems.getComponents<PathComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
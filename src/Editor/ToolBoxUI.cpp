@@ -1074,6 +1074,42 @@ void ToolBoxUI::drawResourceManager()
     ImGui::End();
 }
 
+//! entity slots in the arena per type and component colonies of the world
+void ToolBoxUI::drawMemoryStats()
+{
+    if (!p_world)
+    {
+        return;
+    }
+
+    if (ImGui::Begin("Memory"))
+    {
+        if (ImGui::CollapsingHeader("Entities"))
+        {
+            const auto &arena = p_world->getArena();
+            for (int type_id = 0; type_id < static_cast<int>(TypeId::Count); ++type_id)
+            {
+                auto stats = arena.getStats(type_id);
+                if (stats.slot_size == 0)
+                {
+                    continue;
+                }
+                ImGui::Text("%s: %zu live (peak %zu), %zu chunks, %zu B reserved",
+                            enumToString(static_cast<TypeId>(type_id)), stats.live_count, stats.peak_live_count,
+                            stats.chunk_count, stats.bytes_reserved);
+            }
+        }
+        if (ImGui::CollapsingHeader("Components"))
+        {
+            for (auto &info : p_world->m_systems.memoryReport())
+            {
+                ImGui::Text("%s: %zu, %zu / %zu B", info.type_name.c_str(), info.count, info.bytes_used, info.bytes_reserved);
+            }
+        }
+    }
+    ImGui::End();
+}
+
 void ToolBoxUI::draw()
 {
     // Start the Dear ImGui frame
@@ -1082,6 +1118,7 @@ void ToolBoxUI::draw()
     ImGui::NewFrame();
 
     drawResourceManager();
+    drawMemoryStats();
 
     ImGui::Begin("Shaders");
     {
@@ -26,6 +26,16 @@ void CharSeq::onCreation()
 
     m_world->m_systems.addEntity(getId(), c_comp, t_comp);
 }
+void CharSeq::update(float dt)
+{
+    if (m_pending_size)
+    {
+        setSize(*m_pending_size);
+        m_pending_size.reset();
+    }
+    GameObject::update(dt);
+}
+
 void CharSeq::draw(LayersHolder &target, Assets& assets)
 {
     Text seq(m_sequence);
@@ -34,7 +44,11 @@ void CharSeq::draw(LayersHolder &target, Assets& assets)
     seq.setColor({255,255,255,255});
 
     auto bb = seq.getBoundingBox();
-    m_size = {bb.width, bb.height};
+    //! transforms must not be written while drawing, the size is applied in update
+    if (bb.width != m_size.x || bb.height != m_size.y)
+    {
+        m_pending_size = utils::Vector2f{static_cast<float>(bb.width), static_cast<float>(bb.height)};
+    }
 
     target.getCanvas("Unit").drawText2(seq);
 
@@ -206,7 +206,7 @@ void PlayerShip::onBoostUp()
 
 void PlayerShip::onCreation()
 {
-    m_size = 12.;
+    setSize(12.);
 
     CollisionComponent c_comp;
     Polygon shape = {4};
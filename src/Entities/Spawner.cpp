@@ -8,6 +8,7 @@ Spawner::Spawner(GameWorld &world, const Spec &spec, int ent_id)
     m_period = spec.period;
     m_delay = spec.delay;
     m_spawn_count= spec.spawn_count;
+    m_max_alive = spec.max_alive;
     
     m_spawnee = spec.spawned_spec;
     m_spawnee.obj_type = TypeId::TextBubble; 
@@ -18,6 +19,12 @@ void Spawner::onCreation()
     TimedEventComponent t_comp;
     t_comp.addEvent({[this](float t, int c)
                      {
+                         //! counted from the per type list, so checking the cap does not walk all entities
+                         if (m_max_alive >= 0 &&
+                             m_world->getNActiveEntities(m_spawnee.obj_type) >= static_cast<std::size_t>(m_max_alive))
+                         {
+                             return;
+                         }
                          m_spawnee.pos = getPosition();
                          m_world->createObject(m_spawnee);
                      },
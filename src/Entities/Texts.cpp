@@ -157,6 +157,11 @@ void TextBubble::update(float dt)
 {
 
     m_timers.update(dt);
+    if (m_pending_size)
+    {
+        setSize(*m_pending_size);
+        m_pending_size.reset();
+    }
 
     if (m_pos.y < 0.f && m_vel.y < 0.f)
     {
@@ -165,9 +170,14 @@ void TextBubble::update(float dt)
     m_pos += m_vel * dt;
 }
 
+bool TextBubble::canSleep()
+{
+    return m_timers.isEmpty() && !m_pending_size;
+}
+
 void TextBubble::setTextHeight(float height)
 {
-    m_size.y = height;
+    setSize({m_size.x, height});
 }
 
 void TextBubble::draw(LayersHolder &layers, Assets &assets)
@@ -239,7 +249,12 @@ void TextBubble::draw(LayersHolder &layers, Assets &assets)
     m_drawable.setScale(1.f, 1.f);
     auto bb = m_drawable.getBoundingBox();
 
-    m_size = {bb.width, bb.height};
+    //! transforms must not be written while drawing, the size is applied in update
+    if (bb.width != m_size.x || bb.height != m_size.y)
+    {
+        m_pending_size = utils::Vector2f{static_cast<float>(bb.width), static_cast<float>(bb.height)};
+        wake();
+    }
     float aspect = (float)bb.height / (float)bb.width;
 
     m_drawable.centerAround(m_pos);
@@ -22,6 +22,12 @@ void Wall::onCreation()
     m_world->m_systems.addEntity(getId(), c_comp);
 }
 
+//! walls only move when something moves them
+bool Wall::canSleep()
+{
+    return true;
+}
+
 void Wall::onCollisionWith(GameObject &obj, CollisionData &c_data)
 {
 }
@@ -97,6 +103,11 @@ void PathingWall::update(float dt)
     m_reached_next_point.update(dt);
 }
 
+bool PathingWall::canSleep()
+{
+    return m_path.steps.empty() && m_reached_next_point.isEmpty();
+}
+
 void PathingWall::setPath(const Path &path, float speed)
 {
     m_speed = speed;
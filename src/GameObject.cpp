@@ -1,19 +1,43 @@
 #include "GameObject.h"
 
 #include "Polygon.h"
+#include "GameWorld.h"
+#include "TransformStore.h"
+
+//! objects inside of a world keep their transform in its TransformStore at the slot of their id
+static TransformStore *claimTransform(GameWorld *world, int id)
+{
+    if (!world)
+    {
+        return nullptr;
+    }
+    auto &store = world->getTransforms();
+    store.claim(id);
+    return &store;
+}
 
 GameObject::GameObject(GameWorld *world, const GameObjectSpec &spec, int id, ObjectType type)
-    : m_pos(spec.pos),
-      m_vel(spec.vel),
-      m_size(spec.size),
-      m_angle(spec.angle),
-      m_world(world), m_id(id), m_type(type)
+    : GameObject(world, id, type)
 {
+    m_pos = spec.pos;
+    m_vel = spec.vel;
+    m_size = spec.size;
+    m_angle = spec.angle;
 }
 
 GameObject::GameObject(GameWorld *world, int id, ObjectType type)
-    : m_world(world), m_id(id), m_type(type)
+    : p_transforms(claimTransform(world, id)),
+      m_pivot(p_transforms ? p_transforms->pivot(id) : m_transform.pivot),
+      m_id(id),
+      m_pos(p_transforms ? p_transforms->position(id) : m_transform.trans),
+      m_angle(p_transforms ? p_transforms->angle(id) : m_transform.angle),
+      m_size(p_transforms ? p_transforms->size(id) : m_transform.scale),
+      m_world(world), m_type(type)
 {
+    m_pos = {0.f, 0.f};
+    m_angle = 0.f;
+    m_size = {1.f, 1.f};
+    m_pivot = {0.f, 0.f};
 }
 
 void GameObject::update(float dt)
@@ -35,7 +59,13 @@ void GameObject::draw(LayersHolder &target, Assets &assets) {}
 
 void GameObject::updateAll(float dt)
 {
+    auto old_state = beforeUpdate();
+    update(dt);
+    afterUpdate(old_state);
+}
 
+GameObject::UpdateState GameObject::beforeUpdate()
+{
     if (m_parent)
     {
         // m_pos = m_parent->getPosition();
@@ -43,7 +73,67 @@ void GameObject::updateAll(float dt)
         m_vel = m_parent->m_vel;
     }
 
-    update(dt);
+    //! entities write their transform directly in update, so we detect the change after it
+    return {m_pos, m_angle, m_size};
+}
+
+void GameObject::afterUpdate(const UpdateState &old_state)
+{
+    if (m_pos.x != old_state.pos.x || m_pos.y != old_state.pos.y || m_angle != old_state.angle ||
+        m_size.x != old_state.size.x || m_size.y != old_state.size.y)
+    {
+        markTransformChanged();
+    }
+    else if (m_vel.x == 0.f && m_vel.y == 0.f && m_acc.x == 0.f && m_acc.y == 0.f && canSleep())
+    {
+        m_idle_ticks++;
+        m_is_sleeping = m_idle_ticks >= SLEEP_AFTER_TICKS;
+    }
+    else
+    {
+        m_idle_ticks = 0;
+    }
+}
+
+void GameObject::markTransformChanged()
+{
+    if (p_transforms)
+    {
+        p_transforms->markChanged(m_id);
+    }
+    wake();
+}
+
+bool GameObject::canSleep()
+{
+    return false;
+}
+
+void GameObject::setStatic(bool is_static)
+{
+    m_is_static = is_static;
+    wake();
+}
+
+bool GameObject::isStatic() const
+{
+    return m_is_static;
+}
+
+bool GameObject::isSleeping() const
+{
+    return m_is_sleeping;
+}
+
+void GameObject::wake()
+{
+    m_is_sleeping = false;
+    m_idle_ticks = 0;
+}
+
+bool GameObject::isAwake() const
+{
+    return !m_is_static && !m_is_sleeping;
 }
 
 bool GameObject::isRoot() const
@@ -87,10 +177,25 @@ void GameObject::setDestructionCallback(std::function<void(int, ObjectType)> cal
     m_on_destruction_callback = callback;
 }
 
+void GameObject::setParent(GameObject *parent)
+{
+    m_parent = parent;
+    if (p_transforms)
+    {
+        assert(!parent || parent->p_transforms == p_transforms);
+        p_transforms->parent(m_id) = parent ? parent->getId() : -1;
+        p_transforms->markChanged(m_id);
+    }
+    if (m_world)
+    {
+        m_world->onParentChanged(*this);
+    }
+}
+
 void GameObject::addChild(GameObject *child)
 {
     m_children.push_back(child);
-    child->m_parent = this;
+    child->setParent(this);
 }
 
 void GameObject::removeChild(GameObject *child)
@@ -123,14 +228,25 @@ bool GameObject::isDead() const
     return m_is_dead;
 }
 
+//! the setters ignore writes of the current value, so that objects setting their pose every frame are not seen as changed
 void GameObject::setPosition(utils::Vector2f new_position)
 {
+    if (new_position.x == m_pos.x && new_position.y == m_pos.y)
+    {
+        return;
+    }
     m_pos = new_position;
+    markTransformChanged();
 }
 
 void GameObject::setSize(utils::Vector2f size)
 {
+    if (size.x == m_size.x && size.y == m_size.y)
+    {
+        return;
+    }
     m_size = size;
+    markTransformChanged();
 }
 
 const utils::Vector2f &GameObject::getSize() const
@@ -140,7 +256,12 @@ const utils::Vector2f &GameObject::getSize() const
 
 void GameObject::setAngle(float angle)
 {
+    if (angle == m_angle)
+    {
+        return;
+    }
     m_angle = angle;
+    markTransformChanged();
 }
 
 void GameObject::move(utils::Vector2f by)
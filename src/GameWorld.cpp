@@ -1,29 +1,31 @@
 #include "GameWorld.h"
 
 #include <chrono>
+#include <algorithm>
 
 #include "Utils/RandomTools.h"
 
 #include "Factories.h"
 
-//! EXPERIMENTAL ARENA FOR STORING OBJECTS!
-ObjectArena arena;
-
-ObjectArena &GameWorld::getArena() const
+ObjectArena &GameWorld::getArena()
+{
+    return m_arena;
+}
+const ObjectArena &GameWorld::getArena() const
 {
-    return arena;
+    return m_arena;
 }
-void GameWorld::registerObject(int type_id, std::size_t size)
+void GameWorld::registerObject(int type_id, std::size_t size, std::size_t alignment)
 {
-    arena.registerObject(type_id, size);
+    m_arena.registerObject(type_id, size, alignment);
 }
 void *GameWorld::allocateObject(int type_id)
 {
-    return arena.allocateObject(type_id);
+    return m_arena.allocateObject(type_id);
 }
 void GameWorld::deallocateObject(int type_id, void *obj_p)
 {
-    return arena.deallocateObject(type_id, obj_p);
+    return m_arena.deallocateObject(type_id, obj_p);
 }
 
 
@@ -36,18 +38,81 @@ std::unordered_map<TypeId, std::unique_ptr<FactoryBase>> createFactories(GameWor
 }
 
 GameWorld::GameWorld(PostOffice &messenger)
-    : p_messenger(&messenger), m_systems(m_entities), m_collision_system(messenger, m_systems.getComponents<CollisionComponent>())
+    : p_messenger(&messenger), m_systems(m_entities, m_transforms), m_collision_system(messenger, m_systems.getComponents<CollisionComponent>(), m_transforms)
 {
+    m_systems.setThreadPool(&m_thread_pool);
+    m_collision_system.setThreadPool(&m_thread_pool);
     m_factories = createFactories<TYPE_LIST>(*this);
+    registerExactTypes<TYPE_LIST>();
     registerSerializers();
 }
 
-std::size_t GameWorld::getNActiveEntities(ObjectType type)
+std::size_t GameWorld::getNActiveEntities(ObjectType type) const
+{
+    return m_type2entities[static_cast<std::size_t>(type)].size();
+}
+
+void GameWorld::addToTypeList(GameObject &object)
+{
+    auto id = object.getId();
+    if (id >= static_cast<int>(m_id2type_pos.size()))
+    {
+        m_id2type_pos.resize(id + 1, -1);
+        m_id2exact_type.resize(id + 1, false);
+        m_id2update_tick.resize(id + 1, 0);
+    }
+    auto type_ind = static_cast<std::size_t>(object.getType());
+    auto &entities = m_type2entities[type_ind];
+    m_id2type_pos[id] = entities.size();
+    entities.push_back(&object);
+
+    m_id2exact_type[id] = m_exact_types[type_ind] && typeid(object) == *m_exact_types[type_ind];
+    m_id2update_tick[id] = 0;
+}
+
+template <class... EntityTypes>
+void GameWorld::registerExactTypes()
+{
+    ((m_exact_types[static_cast<std::size_t>(getTypeId<EntityTypes>())] = &typeid(EntityTypes)), ...);
+}
+
+template <class... EntityTypes>
+void GameWorld::updateTypeBatches(float dt)
+{
+    (updateTypeBatch<EntityTypes>(dt), ...);
+}
+
+//! only objects outside of any hierarchy, the order between them does not matter
+template <class EntityType>
+void GameWorld::updateTypeBatch(float dt)
+{
+    for (auto p_object : m_type2entities[static_cast<std::size_t>(getTypeId<EntityType>())])
+    {
+        auto id = p_object->getId();
+        if (!m_id2exact_type[id] || !p_object->isAwake() || p_object->m_parent || !p_object->m_children.empty())
+        {
+            continue;
+        }
+        m_id2update_tick[id] = m_tick;
+        p_object->updateAllAs<EntityType>(dt);
+    }
+}
+
+void GameWorld::setUpdateMode(UpdateMode mode)
+{
+    m_update_mode = mode;
+}
+
+void GameWorld::removeFromTypeList(GameObject &object)
 {
-    auto &entities = m_entities.data();
-    auto n_enemies = std::count_if(entities.begin(), entities.end(), [type](auto &obj)
-                                   { return obj->getType() == type; });
-    return n_enemies;
+    auto &entities = m_type2entities[static_cast<std::size_t>(object.getType())];
+    auto pos = m_id2type_pos[object.getId()];
+    assert(pos != -1 && entities[pos] == &object);
+
+    entities[pos] = entities.back();
+    m_id2type_pos[entities[pos]->getId()] = pos;
+    entities.pop_back();
+    m_id2type_pos[object.getId()] = -1;
 }
 
 std::shared_ptr<GameObject> GameWorld::insertObject(std::function<std::shared_ptr<GameObject>(int)> obj_maker)
@@ -67,6 +132,14 @@ GameObject &GameWorld::addObject3(ObjectType type)
     return *entity_p;
 }
 
+//! the rect an entity occupies when culling
+static AABB drawRect(const GameObject &object)
+{
+    auto half_size = object.getSize() / 2.f;
+    auto pos = object.getPosition();
+    return {pos - half_size, pos + half_size};
+}
+
 void GameWorld::addQueuedEntities()
 {
     while (!m_to_add.empty())
@@ -76,7 +149,7 @@ void GameWorld::addQueuedEntities()
         m_entities.insertAt(new_id, new_object);
         assert(new_id == m_entities.at(new_id)->getId());
 
-        p_messenger->send(EntityCreatedEvent{new_id, new_object->getPosition()});
+        p_messenger->send(EntityCreatedEvent{new_id, new_object->getPosition(), m_entities.getHandle(new_id)});
 
         m_entities.at(new_id)->onCreation();
         if (m_systems.has<CollisionComponent>(new_id))
@@ -84,10 +157,9 @@ void GameWorld::addQueuedEntities()
             m_collision_system.insertObject(*m_entities.at(new_id));
         }
 
-        if (m_entities.at(new_id)->isRoot())
-        {
-            m_root_entities.insertAt(new_id, new_id);
-        }
+        m_hierarchy.insert(*new_object);
+        m_draw_tree.addRect(drawRect(*new_object).inflate(1.5f), new_id);
+        addToTypeList(*new_object);
 
         m_to_add.pop_front();
     }
@@ -96,27 +168,14 @@ void GameWorld::addQueuedEntities()
 void removeEntity(GameObject *entity,
                   GameSystems &systems,
                   EntityRegistryT &entities,
-                  utils::DynamicObjectPool2<int> &root_entities,
                   Collisions::CollisionSystem &collision_system)
 {
     auto id = entity->getId();
     entity->onDestruction();
 
-    //! destroy also the object's children and remove it from roots if necessary
-    if (entity->isRoot())
+    //! the whole subtree is being removed, so only the parent of its root needs to forget about it
+    if (entity->m_parent)
     {
-        root_entities.remove(id);
-        //! children become roots
-        for (auto p_child : entity->m_children)
-        {
-            p_child->m_parent = nullptr;
-            auto child_id = p_child->getId();
-            assert(!root_entities.contains(child_id));
-            root_entities.insertAt(child_id, child_id);
-        }
-    }
-    else
-    { //! entity has a parent so it should be removed from it's children
         entity->m_parent->removeChild(entity);
     }
 
@@ -138,44 +197,57 @@ void GameWorld::removeParent(GameObject &child)
     //! children become roots
     for (auto p_child : child.m_parent->m_children)
     {
-        p_child->m_parent = nullptr;
-        auto child_id = p_child->getId();
-        assert(!m_root_entities.contains(child_id));
-        m_root_entities.insertAt(child_id, child_id);
+        p_child->setParent(nullptr);
     }
 }
-void GameWorld::removeQueuedEntities()
+
+void GameWorld::onParentChanged(GameObject &child)
 {
+    m_reparented.push_back(getHandle(child.getId()));
+}
 
-    //! we destroy the objects from children to parents, this way it doesn't get fucked
-    //! TODO: The entity-tree logic should not be done in GameWorld, Add it's own thing for that
-    std::deque<GameObject *> to_destroy;
-    std::unordered_set<int> already_destroyed; //! for
-    while (!m_to_destroy.empty())
+void GameWorld::applyParentChanges()
+{
+    for (auto handle : m_reparented)
     {
-        auto object = m_to_destroy.back();
-        m_to_destroy.pop_back();
-
-        assert(!already_destroyed.contains(object->getId()));
-        already_destroyed.insert(object->getId());
-
-        to_destroy.push_front(object.get());
-
-        for (auto p_child : object->m_children)
+        auto p_object = get(handle);
+        if (p_object && m_hierarchy.contains(handle.index))
         {
-            assert(!already_destroyed.contains(p_child->getId()));
-            already_destroyed.insert(p_child->getId());
-
-            to_destroy.push_front(p_child);
+            m_hierarchy.reattach(*p_object);
         }
     }
+    m_reparented.clear();
+}
+
+void GameWorld::removeQueuedEntities()
+{
+    //! destroying an object destroys its whole subtree, children are destroyed before their parents
+    m_removed_buffer.clear();
+    for (auto &object : m_to_destroy)
+    {
+        m_hierarchy.markSubtreeForRemoval(*object, m_removed_buffer);
+    }
     m_to_destroy.clear();
+    if (m_removed_buffer.empty())
+    {
+        return;
+    }
 
-    for (auto object : to_destroy)
+    for (auto object : m_removed_buffer)
     {
-        p_messenger->send(EntityDiedEvent{object->getType(), object->getId(), object->getPosition()});
-        removeEntity(object, m_systems, m_entities, m_root_entities, m_collision_system);
+        p_messenger->send(EntityDiedEvent{object->getType(), object->getId(), object->getPosition(), m_entities.getHandle(object->getId())});
+        //! children left here were not part of the subtree (they got reparented this frame), they become roots,
+        //! setParent also resets their parent in the transforms and lets the hierarchy know
+        for (auto p_child : object->m_children)
+        {
+            p_child->setParent(nullptr);
+        }
+        object->m_children.clear();
+        m_draw_tree.removeObject(object->getId());
+        removeFromTypeList(*object);
+        removeEntity(object, m_systems, m_entities, m_collision_system);
     }
+    m_hierarchy.compact();
 }
 
 void GameWorld::destroyObject(int entity_id)
@@ -183,64 +255,119 @@ void GameWorld::destroyObject(int entity_id)
     m_to_destroy.push_back(m_entities.at(entity_id));
 }
 
+void GameWorld::shrinkAfterRemovals()
+{
+    m_shrink_after_removals = true;
+}
+
 void GameWorld::update(float dt)
 {
+    m_transforms.storePrevious();
 
     m_systems.preUpdate(dt);
     m_collision_system.preUpdate(dt, m_entities);
     m_systems.update(dt);
     m_systems.postUpdate(dt);
 
-    std::deque<GameObject *> to_update;
-    for (auto id : m_root_entities.data())
+    m_tick++;
+    if (m_update_mode == UpdateMode::TypeBatched)
     {
-        to_update.push_back(m_entities.at(id).get());
+        updateTypeBatches<TYPE_LIST>(dt);
     }
-    //! we update the entities starting from parents ending with children
-    while (!to_update.empty())
+
+    //! the hierarchy is ordered parents first, and does not change until applyParentChanges
+    for (auto current : m_hierarchy.order())
     {
-        auto current = to_update.front();
-        to_update.pop_front();
-        current->updateAll(dt);
-        // current->update(dt);
-        if (current->isDead())
+        if (current->isAwake() && m_id2update_tick[current->getId()] != m_tick)
         {
-            destroyObject(current->getId());
+            current->updateAll(dt);
         }
-
-        for (auto child : current->m_children)
+        if (current->isDead())
         {
-            to_update.push_back(child);
+            destroyObject(current->getId());
         }
     }
 
+    applyParentChanges();
     addQueuedEntities();
     removeQueuedEntities();
+
+    //! the killed entities were destroyed in the sweep above and their components erased just now
+    if (m_shrink_after_removals)
+    {
+        m_systems.shrink_to_fit();
+        m_shrink_after_removals = false;
+    }
 }
 
 void GameWorld::checkComponentsConsistency()
 {
 }
 
-void GameWorld::draw(LayersHolder &layers, Assets &assets, Renderer &window, const View &camera_view)
+void GameWorld::refreshDrawRect(GameObject &object)
+{
+    auto fitting_rect = drawRect(object);
+    const auto &tree_rect = m_draw_tree.getObjectRect(object.getId());
+    bool fits = fitting_rect.r_min.x >= tree_rect.r_min.x && fitting_rect.r_min.y >= tree_rect.r_min.y &&
+                fitting_rect.r_max.x <= tree_rect.r_max.x && fitting_rect.r_max.y <= tree_rect.r_max.y;
+    if (!fits)
+    {
+        m_draw_tree.removeObject(object.getId());
+        m_draw_tree.addRect(fitting_rect.inflate(1.5f), object.getId());
+    }
+    //! children move with their parents
+    for (auto p_child : object.m_children)
+    {
+        if (m_hierarchy.contains(p_child->getId()))
+        {
+            refreshDrawRect(*p_child);
+        }
+    }
+}
+
+//! only entities whose transform changed since the last draw are touched
+void GameWorld::refreshDrawRects()
 {
-    View extended_camera = camera_view;
-    extended_camera.setSize(camera_view.getSize() * 2.f);
+    m_transforms.drainChanged([this](int id)
+                              {
+        //! entities which are still queued get their rect when added
+        if (m_hierarchy.contains(id))
+        {
+            refreshDrawRect(*m_entities.at(id));
+        } });
+}
 
-    for (auto &obj : m_entities.data())
+void GameWorld::draw(LayersHolder &layers, Assets &assets, Renderer &window, const View &camera_view, float interpolation)
+{
+    refreshDrawRects();
+    bool interpolate = interpolation < 1.f;
+    if (interpolate)
     {
-        Rectf obj_rect;
-        auto size = obj->getSize();
-        obj_rect.pos_x = obj->getPosition().x - size.x / 2.f;
-        obj_rect.pos_y = obj->getPosition().y - size.y / 2.f;
-        obj_rect.width = size.x;
-        obj_rect.height = size.y;
-        if (extended_camera.intersects(obj_rect))
+        m_transforms.beginInterpolation(interpolation);
+    }
+
+    //! the view is extended so that objects sticking out of their rect are not culled too early
+    auto view_size = camera_view.getSize() * 2.f;
+    AABB view_rect = {camera_view.getCenter() - view_size / 2.f, camera_view.getCenter() + view_size / 2.f};
+
+    m_visible_entities = m_draw_tree.findIntersectingLeaves(view_rect);
+    std::sort(m_visible_entities.begin(), m_visible_entities.end()); //! stable draw order between frames
+    for (auto id : m_visible_entities)
+    {
+        auto &obj = m_entities.at(id);
+        if (intersects(view_rect, drawRect(*obj)))
         {
             obj->draw(layers, assets);
         }
     }
 
+    m_systems.draw();
+
+    if (interpolate)
+    {
+        m_transforms.endInterpolation();
+    }
+
 #ifdef DEBUG
     checkComponentsConsistency();
 #endif
@@ -260,6 +387,52 @@ return m_factories.at(spec.obj_type)->create(spec);
         return m_entities.at(entity_id).get();
     }
 
+    GameObject *GameWorld::get(EntityHandle handle)
+    {
+        auto p_entity = m_entities.get(handle);
+        return p_entity ? p_entity->get() : nullptr;
+    }
+
+    //! entities waiting to be added get the handle they will have once they are in
+    EntityHandle GameWorld::getHandle(int entity_id) const
+    {
+        if (m_entities.contains(entity_id))
+        {
+            return m_entities.getHandle(entity_id);
+        }
+        auto is_queued = std::any_of(m_to_add.begin(), m_to_add.end(), [entity_id](const auto &p_object)
+                                     { return p_object->getId() == entity_id; });
+        return is_queued ? m_entities.getReservedHandle(entity_id) : EntityHandle{};
+    }
+
+    bool GameWorld::isAlive(EntityHandle handle) const
+    {
+        return m_entities.isValid(handle);
+    }
+
+    void GameWorld::saveSnapshot(WorldSnapshot &snapshot)
+    {
+        snapshot.blob.clear();
+        utils::BinaryWriter writer(snapshot.blob);
+        m_transforms.writeSnapshot(writer);
+        m_systems.writeSnapshot(writer, snapshot.copies);
+    }
+
+    void GameWorld::restoreSnapshot(const WorldSnapshot &snapshot)
+    {
+        utils::BinaryReader reader(snapshot.blob);
+        m_transforms.readSnapshot(reader);
+        m_systems.readSnapshot(reader, snapshot.copies);
+        assert(reader.isAtEnd());
+        //! manifolds cached for the old positions would let pairs which did not move since skip the narrow phase
+        m_collision_system.clearContacts();
+    }
+
+    TransformStore &GameWorld::getTransforms()
+    {
+        return m_transforms;
+    }
+
     EntityRegistryT &GameWorld::getEntities()
     {
         return m_entities;
@@ -96,8 +96,8 @@ void DodgeGame::registerSystems()
     auto &systems = m_world->m_systems;
 
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
-    systems.registerSystem(std::make_shared<PathSystem>(systems.getComponents<PathComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
+    systems.registerSystem(std::make_shared<PathSystem>(systems.getComponents<PathComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
@@ -117,21 +117,14 @@ std::shared_ptr<GameLevelA> DodgeGame::levelFactory(int level_id, utils::Vector2
     auto level = std::make_shared<GameLevelA>(*m_world, level_id, messanger);
 
     std::filesystem::path cave_json_path = std::string{RESOURCES_DIR} + "Levels/wallShapes.json";
-    std::unordered_map<std::string, CaveSpec2> caves = readCaveSpecs3(cave_json_path);
-    const auto &level_data = caves.at("Level1");
+    m_level_streamer = std::make_unique<LevelStreamer>(*m_world);
+    m_level_streamer->open(cave_json_path, "Level1");
+    //! the size is needed right away, the objects are created only around the camera in updateImpl
+    const auto &level_data = m_level_streamer->waitForLevel();
     float level_width = level_data.level_size.x;
     float level_height = level_data.level_size.y;
-    ;
-    auto spawn_cave = [this, level_width, level_height](const CaveSpec2 &cave)
-    {
-        for (auto spec : cave.objects)
-        {
-            m_factories.at(spec->obj_type)->create(*spec);
-        }
-    };
 
     // m_timers.addInfiniteEvent(spawn_event, 5.f, 0.f);
-    spawn_cave(level_data);
 
     m_camera.setPostition({m_playerx->getPosition().x, level_height / 2.f});
     float window_aspect = m_window.getTarget().getAspect();
@@ -167,19 +160,6 @@ std::shared_ptr<GameLevelA> DodgeGame::levelFactory(int level_id, utils::Vector2
     std::cout << "Camera view: " << m_camera.getView().getSize().y << std::endl;
     m_camera.setPostition({300, level_height / 2.f});
 
-    std::vector<std::string> cave_keys; //! for randomly generating caves;
-    //! normalize posiitons of specs
-    for (auto &[key, cave] : caves)
-    {
-        cave_keys.push_back(key);
-        // auto bb = cave.bounds;
-        for (auto spec : cave.objects)
-        {
-            // spec->pos -= Vec2{bb.pos_x, bb.pos_y};
-            // spec->pos.x += 0 * level_width;
-        }
-    }
-
     auto &stuff_killer = m_world->addObject3(ObjectType::Trigger);
     stuff_killer.setSize({10.f, level_height});
     stuff_killer.m_vel = {wall_speed, 0.f};
@@ -200,6 +180,14 @@ std::shared_ptr<GameLevelA> DodgeGame::levelFactory(int level_id, utils::Vector2
     return level;
 }
 
+void DodgeGame::updateImpl(const float dt)
+{
+    if (m_level_streamer)
+    {
+        m_level_streamer->update(m_camera.getView());
+    }
+}
+
 void DodgeGame::drawImpl(Renderer &win)
 {
     auto old_view = win.m_view;
@@ -180,7 +180,6 @@ void DungeonGame::startLevel(std::string id)
     {
         return;
     }
-
     auto &lvl = m_levels.at(id);
     Vec2 ll_bound = {lvl.origin};
     level_size = lvl.level_size;
@@ -247,9 +246,9 @@ void DungeonGame::registerSystems()
     colllider.registerResolver(ObjectType::Box, ObjectType::Wall);
 
     auto &systems = m_world->m_systems;
-    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>()));
+    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>(), systems.getTransforms()));
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
@@ -343,6 +343,7 @@ Game::Game(Renderer &window, KeyBindings &bindings, Assets &assets)
                {START_VIEW_SIZE, START_VIEW_SIZE * window.getTargetSize().y / window.getTargetSize().x},
                messanger)
 {
+    m_prev_camera_center = m_camera.getView().getCenter();
 
     m_textures.get("SkyNight2")->setWrapX(TexWrapParam::Repeat);
     m_textures.get("BrickWall")->setWrapX(TexWrapParam::Repeat);
@@ -705,6 +706,7 @@ void Game::update(float dt)
     {
         m_levels.front()->update(dt);
     }
+    m_prev_camera_center = m_camera.getView().getCenter();
     m_camera.update(dt);
 
     m_timers.update(dt);
@@ -721,10 +723,19 @@ void Game::update(float dt)
     // }
 };
 
+void Game::setRenderInterpolation(float alpha)
+{
+    m_render_alpha = alpha;
+}
+
 void Game::draw(Renderer &window)
 {
     auto tic = timeNow();
 
+    auto camera_view = m_camera.getView();
+    auto camera_center = camera_view.getCenter();
+    camera_view.setCenter(m_prev_camera_center + (camera_center - m_prev_camera_center) * m_render_alpha);
+
     // Sprite background_rect;
     auto old_view = window.m_view;
     m_window.m_view = m_window.getDefaultView();
@@ -739,7 +750,7 @@ void Game::draw(Renderer &window)
         m_window.drawSprite(m_background);
         m_window.drawAll();
     }
-    m_window.m_view = m_camera.getView();
+    m_window.m_view = camera_view;
 
 
     m_layers.getLayer("Unit")->setBackground({0.f, 0.f, 0.f, 0.f});
@@ -750,7 +761,7 @@ void Game::draw(Renderer &window)
     ss.setPosition(buffer_size / 2.f);
     ss.setScale(buffer_size / 2.f);
     m_window.m_blend_factors = {BlendFactor::One, BlendFactor::OneMinusSrcAlpha};
-    m_world->draw(m_layers, m_assets, m_window, m_camera.getView());
+    m_world->draw(m_layers, m_assets, m_window, camera_view, m_render_alpha);
     m_layers.setView(m_window.m_view);
 
     // RectangleSimple mouse_rect;
@@ -24,6 +24,8 @@ void GameLevel::killEntities()
         m_world.get(ent_id)->kill();
     }
     m_entity_ids.clear();
+    //! the level is gone, its components need not keep their memory once they are erased
+    m_world.shrinkAfterRemovals();
 }
 
 void GameLevel::update(float dt)
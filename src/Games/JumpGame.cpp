@@ -202,10 +202,6 @@ JumpGame::JumpGame(Renderer &window, KeyBindings &bindings, Assets &assets)
 }
 void JumpGame::updateImpl(const float dt)
 {
-    for (auto ent_p : m_world->getEntities().data())
-    {
-    }
-
     //! move background with camera;
     utils::Vector2f bg_tex_pos = m_camera.getView().getCenter() / 2.f;
     auto bg_size = m_background_tex->getSize();
@@ -426,9 +422,9 @@ void JumpGame::registerSystems()
     auto &systems = m_world->m_systems;
 
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
-    systems.registerSystem(std::make_shared<PathSystem>(systems.getComponents<PathComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>(), systems.getTransforms()));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
+    systems.registerSystem(std::make_shared<PathSystem>(systems.getComponents<PathComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
@@ -100,9 +100,9 @@ void SnakeGame::registerSystems()
     auto &colllider = m_world->getCollisionSystem();
 
     auto &systems = m_world->m_systems;
-    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>()));
+    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>(), systems.getTransforms()));
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
@@ -149,7 +149,6 @@ void SnakeGameSP::startLevel(std::string id)
     {
         return;
     }
-
     auto &lvl = m_levels.at(id);
     Vec2 ll_bound = {lvl.origin};
     level_size = lvl.level_size;
@@ -210,9 +209,9 @@ void SnakeGameSP::registerSystems()
     colllider.registerResolver(ObjectType::Snake, ObjectType::Wall);
 
     auto &systems = m_world->m_systems;
-    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>()));
+    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>(), systems.getTransforms()));
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
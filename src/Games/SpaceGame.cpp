@@ -54,6 +54,8 @@ SpaceGame::SpaceGame(Renderer &window, KeyBindings &bindings, Assets &assets)
     : Game(window, bindings, assets),
       m_pos_generator(messanger, {m_font->getLineHeight() * 2, m_font->getLineHeight() * 2.f}, {800.f, 800.f})
 {
+    //! meteors, bullets and words never get parents, so they are updated in batches of their type without virtual calls
+    m_world->setUpdateMode(GameWorld::UpdateMode::TypeBatched);
 
     m_player = std::static_pointer_cast<PlayerShip>(m_world->insertObject([&, this](int ent_id)
                                                                           {
@@ -172,7 +174,6 @@ void SpaceGame::startLevel(std::string id)
     {
         return;
     }
-
     auto &lvl = m_levels.at(id);
     Vec2 ll_bound = {lvl.origin};
     level_size = lvl.level_size;
@@ -221,6 +222,8 @@ void SpaceGame::startLevel(std::string id)
 void SpaceGame::registerSystems()
 {
     auto &colllider = m_world->getCollisionSystem();
+    //! meteors and words keep spawning all over the level, so neighbours in space end up far apart in the colony
+    colllider.setSpatialSorting(true, 64, 100.f);
     colllider.registerResolver(ObjectType::Bullet, ObjectType::TextBubble);
     colllider.registerResolver(ObjectType::Player, ObjectType::TextBubble,
                                [](GameObject &obj1, GameObject &obj2, CollisionData c_data)
@@ -277,9 +280,9 @@ void SpaceGame::registerSystems()
                                });
 
     auto &systems = m_world->m_systems;
-    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>()));
+    systems.registerSystem(std::make_shared<TransformSystem>(systems.getComponents<TransformComponent>(), systems.getTransforms()));
     systems.registerSystem(std::make_shared<TimedEventSystem>(systems.getComponents<TimedEventComponent>()));
-    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), m_layers));
+    systems.registerSystem(std::make_shared<SpriteSystem>(systems.getComponents<SpriteComponent>(), systems.getTransforms(), m_layers));
 
     std::filesystem::path animation_directory = {
         std::string{RESOURCES_DIR} + "Textures/Animations/"};
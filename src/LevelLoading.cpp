@@ -6,7 +6,7 @@
 
 using json = nlohmann::json;
 
-CaveSpec2 readCaveSpec(const json &lvl_data)
+CaveSpec2 readCaveHeader(const json &lvl_data)
 {
     CaveSpec2 spec;
 
@@ -34,21 +34,31 @@ CaveSpec2 readCaveSpec(const json &lvl_data)
                    lvl_data["bounds"][1].get<float>(),
                    lvl_data["bounds"][2].get<float>(),
                    lvl_data["bounds"][3].get<float>()};
+    return spec;
+}
+std::shared_ptr<GameObjectSpec> readObjectSpec(const json &spec_json)
+{
+    std::string type_name = spec_json["obj_type"];
+    try
+    {
+        auto type_id = stringToEnum<ObjectType>(type_name);
+        return deserializeSpec(type_id, spec_json);
+    }
+    catch (std::exception &e)
+    {
+        // std::cout << "Enum does not exist: " << e.what() << std::endl;
+    }
+    return nullptr;
+}
+
+CaveSpec2 readCaveSpec(const json &lvl_data)
+{
+    CaveSpec2 spec = readCaveHeader(lvl_data);
     for (auto &spec_json : lvl_data.at("objects"))
     {
-        std::string type_name = spec_json["obj_type"];
-        try
-        {
-            auto type_id = stringToEnum<ObjectType>(type_name);
-            auto new_spec = deserializeSpec(type_id, spec_json);
-            if (new_spec)
-            {
-                spec.objects.push_back(new_spec);
-            }
-        }
-        catch (std::exception &e)
+        if (auto new_spec = readObjectSpec(spec_json))
         {
-            // std::cout << "Enum does not exist: " << e.what() << std::endl;
+            spec.objects.push_back(new_spec);
         }
     }
     return spec;
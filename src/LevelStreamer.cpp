@@ -0,0 +1,283 @@
+#include "LevelStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+#include "nlohmann/json.hpp"
+
+#include "GameWorld.h"
+#include "Utils/IOUtils.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+    //! the browser build has no spare threads, the work is then done when the result is needed
+#if defined(__EMSCRIPTEN__)
+    constexpr auto PARSE_POLICY = std::launch::deferred;
+#else
+    constexpr auto PARSE_POLICY = std::launch::async;
+#endif
+
+    template <class T>
+    bool isReady(const std::future<T> &future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) != std::future_status::timeout;
+    }
+
+    std::int64_t chunkKey(int x, int y)
+    {
+        return (static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(y);
+    }
+} //! namespace
+
+struct LevelStreamer::ParsedLevel
+{
+    CaveSpec2 info;
+    std::unordered_map<std::int64_t, json> chunk2objects; //! json arrays of objects
+};
+
+struct LevelStreamer::Chunk
+{
+    enum class State
+    {
+        Unloaded,
+        Parsing,
+        Creating,
+        Loaded,
+    };
+
+    AABB rect;
+    json objects; //! kept unparsed while the chunk is unloaded
+
+    State state = State::Unloaded;
+    std::future<std::vector<std::shared_ptr<GameObjectSpec>>> parsing;
+    std::vector<std::shared_ptr<GameObjectSpec>> specs; //! by index in objects, only while creating
+    std::size_t next_to_create = 0;
+
+    std::vector<std::pair<std::size_t, EntityHandle>> entities; //! index in objects and the created entity
+    std::vector<bool> consumed;                                  //! objects destroyed by the game
+};
+
+LevelStreamer::LevelStreamer(GameWorld &world, float chunk_size)
+    : m_world(world), m_chunk_size(chunk_size)
+{
+}
+
+//! pending parse tasks are waited for by their futures
+LevelStreamer::~LevelStreamer() = default;
+
+void LevelStreamer::open(const std::filesystem::path &json_file_path, const std::string &level_key)
+{
+    unloadAll();
+    m_chunks.clear();
+    m_info.reset();
+
+    m_opening = std::async(PARSE_POLICY, [this, json_file_path, level_key]()
+                           {
+        auto parsed = std::make_unique<ParsedLevel>();
+        auto level_data = utils::loadJson(json_file_path.c_str()).at(level_key);
+        parsed->info = readCaveHeader(level_data);
+        for (auto &object : level_data.at("objects"))
+        {
+            utils::Vector2f pos = {0.f, 0.f};
+            if (object.contains("pos"))
+            {
+                pos = {object["pos"][0].get<float>(), object["pos"][1].get<float>()};
+            }
+            auto key = chunkKey(chunkCoord(pos.x), chunkCoord(pos.y));
+            parsed->chunk2objects[key].push_back(std::move(object));
+        }
+        return parsed; });
+}
+
+const CaveSpec2 *LevelStreamer::getLevelInfo() const
+{
+    return m_info.get();
+}
+
+const CaveSpec2 &LevelStreamer::waitForLevel()
+{
+    if (m_opening.valid())
+    {
+        takeParsedLevel();
+    }
+    assert(m_info);
+    return *m_info;
+}
+
+void LevelStreamer::takeParsedLevel()
+{
+    auto parsed = m_opening.get();
+    m_info = std::make_unique<CaveSpec2>(std::move(parsed->info));
+    for (auto &[key, objects] : parsed->chunk2objects)
+    {
+        auto p_chunk = std::make_unique<Chunk>();
+        int x = static_cast<int>(key >> 32);
+        int y = static_cast<int>(static_cast<std::uint32_t>(key));
+        p_chunk->rect = AABB({x * m_chunk_size, y * m_chunk_size}, m_chunk_size, m_chunk_size);
+        p_chunk->consumed.assign(objects.size(), false);
+        p_chunk->objects = std::move(objects);
+        m_chunks[key] = std::move(p_chunk);
+    }
+}
+
+int LevelStreamer::chunkCoord(float x) const
+{
+    return static_cast<int>(std::floor(x / m_chunk_size));
+}
+
+void LevelStreamer::setMargins(float load_margin, float unload_margin)
+{
+    assert(load_margin <= unload_margin); //! otherwise chunks at the border would load and unload every frame
+    m_load_margin = load_margin;
+    m_unload_margin = unload_margin;
+}
+
+void LevelStreamer::setMaxCreatedPerFrame(std::size_t max_count)
+{
+    m_max_created_per_frame = max_count;
+}
+
+std::size_t LevelStreamer::getLoadedChunkCount() const
+{
+    return m_active_chunks.size();
+}
+
+void LevelStreamer::update(const View &camera_view)
+{
+    if (m_opening.valid())
+    {
+        if (!isReady(m_opening))
+        {
+            return;
+        }
+        takeParsedLevel();
+    }
+
+    auto view_min = camera_view.getCenter() - camera_view.getSize() / 2.f;
+    auto view_max = camera_view.getCenter() + camera_view.getSize() / 2.f;
+    AABB load_rect = {view_min - utils::Vector2f{m_load_margin, m_load_margin},
+                      view_max + utils::Vector2f{m_load_margin, m_load_margin}};
+    AABB keep_rect = {view_min - utils::Vector2f{m_unload_margin, m_unload_margin},
+                      view_max + utils::Vector2f{m_unload_margin, m_unload_margin}};
+
+    //! only chunks around the camera are looked at, so long levels cost nothing here
+    for (int x = chunkCoord(load_rect.r_min.x); x <= chunkCoord(load_rect.r_max.x); ++x)
+    {
+        for (int y = chunkCoord(load_rect.r_min.y); y <= chunkCoord(load_rect.r_max.y); ++y)
+        {
+            auto chunk_it = m_chunks.find(chunkKey(x, y));
+            if (chunk_it != m_chunks.end() && chunk_it->second->state == Chunk::State::Unloaded)
+            {
+                startLoading(*chunk_it->second);
+            }
+        }
+    }
+
+    //! unloading goes before creating, entities created in this frame are added to the world only in its next update
+    for (auto p_chunk : m_active_chunks)
+    {
+        if (!intersects(p_chunk->rect, keep_rect) && p_chunk->state != Chunk::State::Parsing)
+        {
+            unload(*p_chunk);
+        }
+    }
+    m_active_chunks.erase(std::remove_if(m_active_chunks.begin(), m_active_chunks.end(), [](auto p_chunk)
+                                         { return p_chunk->state == Chunk::State::Unloaded; }),
+                          m_active_chunks.end());
+
+    std::size_t budget = m_max_created_per_frame;
+    for (auto p_chunk : m_active_chunks)
+    {
+        budget = advance(*p_chunk, budget);
+    }
+}
+
+void LevelStreamer::startLoading(Chunk &chunk)
+{
+    //! the chunk (and so its json) outlives the task, the streamer waits for the future when destroyed
+    const json *p_objects = &chunk.objects;
+    chunk.parsing = std::async(PARSE_POLICY, [p_objects]()
+                               {
+        std::vector<std::shared_ptr<GameObjectSpec>> specs;
+        specs.reserve(p_objects->size());
+        for (auto &object : *p_objects)
+        {
+            specs.push_back(readObjectSpec(object));
+        }
+        return specs; });
+    chunk.state = Chunk::State::Parsing;
+    m_active_chunks.push_back(&chunk);
+}
+
+std::size_t LevelStreamer::advance(Chunk &chunk, std::size_t budget)
+{
+    if (chunk.state == Chunk::State::Parsing)
+    {
+        if (!isReady(chunk.parsing))
+        {
+            return budget;
+        }
+        chunk.specs = chunk.parsing.get();
+        chunk.next_to_create = 0;
+        chunk.state = Chunk::State::Creating;
+    }
+    if (chunk.state != Chunk::State::Creating)
+    {
+        return budget;
+    }
+
+    //! creation is spread over frames so that entering a dense chunk does not stall
+    while (budget > 0 && chunk.next_to_create < chunk.specs.size())
+    {
+        auto index = chunk.next_to_create++;
+        if (chunk.consumed[index] || !chunk.specs[index])
+        {
+            continue;
+        }
+        auto &object = m_world.createObject(*chunk.specs[index]);
+        chunk.entities.push_back({index, m_world.getHandle(object.getId())});
+        budget--;
+    }
+    if (chunk.next_to_create == chunk.specs.size())
+    {
+        chunk.specs.clear();
+        chunk.specs.shrink_to_fit();
+        chunk.state = Chunk::State::Loaded;
+    }
+    return budget;
+}
+
+void LevelStreamer::unload(Chunk &chunk)
+{
+    for (auto [index, handle] : chunk.entities)
+    {
+        if (m_world.isAlive(handle))
+        {
+            m_world.destroyObject(handle.index);
+        }
+        else
+        {
+            chunk.consumed[index] = true;
+        }
+    }
+    chunk.entities.clear();
+    chunk.specs.clear();
+    chunk.specs.shrink_to_fit();
+    chunk.state = Chunk::State::Unloaded;
+}
+
+void LevelStreamer::unloadAll()
+{
+    for (auto p_chunk : m_active_chunks)
+    {
+        if (p_chunk->state == Chunk::State::Parsing)
+        {
+            p_chunk->parsing.wait();
+        }
+        unload(*p_chunk);
+    }
+    m_active_chunks.clear();
+}
@@ -1,58 +1,202 @@
 #include "ObjectArena.h"
 
-/* ObjectArena::ObjectArena()
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    std::size_t roundUp(std::size_t value, std::size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    std::size_t nextPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+} //! namespace
+
+ObjectArena::~ObjectArena()
 {
-    m_chunk_list.emplace_back(CHUNK_SIZE);
+    for (auto &p_pool : m_pools)
+    {
+        if (!p_pool)
+        {
+            continue;
+        }
+        //! objects still alive at this point are leaked by their owners, their memory goes anyway
+        for (auto chunk : p_pool->chunks)
+        {
+            ::operator delete(static_cast<void *>(chunk), std::align_val_t{p_pool->chunk_size});
+        }
+        if (p_pool->spare_chunk)
+        {
+            ::operator delete(static_cast<void *>(p_pool->spare_chunk), std::align_val_t{p_pool->chunk_size});
+        }
+    }
 }
 
-void ObjectArena::registerObject(int type_id, std::size_t obj_size)
+bool ObjectArena::registerObject(int type_id, std::size_t obj_size, std::size_t alignment)
 {
-    if (m_obj_sizes.count(type_id) > 0 && m_obj_sizes.at(type_id) != obj_size)
+    assert(type_id >= 0);
+    alignment = std::max(alignment, alignof(FreeSlot));
+    auto slot_size = roundUp(std::max(obj_size, sizeof(FreeSlot)), alignment);
+
+    if (type_id < static_cast<int>(m_pools.size()) && m_pools[type_id])
     {
-        std::cout << "WARNING OBJECT ALREADY REGISTERED AND HAS DIFFERENT SIZE!" << std::endl;
-        return;
+        auto &pool = *m_pools[type_id];
+        return pool.slot_size == slot_size && pool.alignment == alignment;
+    }
+
+    if (type_id >= static_cast<int>(m_pools.size()))
+    {
+        m_pools.resize(type_id + 1);
     }
-    m_obj_sizes[type_id] = obj_size;
-    m_freelists[type_id] = nullptr;
+    auto p_pool = std::make_unique<TypePool>();
+    p_pool->slot_size = slot_size;
+    p_pool->alignment = alignment;
+    p_pool->first_slot_offset = roundUp(sizeof(ChunkHeader), alignment);
+    //! at least a few objects per chunk, big objects get bigger chunks
+    p_pool->chunk_size = std::max(CHUNK_SIZE, nextPowerOfTwo(p_pool->first_slot_offset + 8 * slot_size));
+    p_pool->slots_per_chunk = (p_pool->chunk_size - p_pool->first_slot_offset) / slot_size;
+    p_pool->stats.slot_size = slot_size;
+    m_pools[type_id] = std::move(p_pool);
+    return true;
 }
 
-void ObjectArena::deallocateObject(int type_id, void *obj)
+bool ObjectArena::isRegistered(int type_id) const
+{
+    return type_id >= 0 && type_id < static_cast<int>(m_pools.size()) && m_pools[type_id];
+}
+
+bool ObjectArena::hasSpace(const TypePool &pool, const ChunkHeader *chunk)
 {
-    std::size_t obj_size = m_obj_sizes.at(type_id);
+    return chunk->free_list || chunk->bumped_count < pool.slots_per_chunk;
+}
 
-    std::byte *curr_head = m_freelists.at(type_id);
-    m_freelists.at(type_id) = static_cast<std::byte *>(obj);
-    *(static_cast<std::byte **>(obj)) = curr_head;
-};
+ObjectArena::ChunkHeader *ObjectArena::newChunk(TypePool &pool)
+{
+    ChunkHeader *chunk;
+    if (pool.spare_chunk)
+    {
+        chunk = pool.spare_chunk;
+        pool.spare_chunk = nullptr;
+    }
+    else
+    {
+        //! aligned to its size so that the chunk of a slot is found by masking its address
+        void *memory = ::operator new(pool.chunk_size, std::align_val_t{pool.chunk_size});
+        chunk = new (memory) ChunkHeader{};
+        chunk->pool = &pool;
+        pool.stats.chunks_allocated++;
+        pool.stats.bytes_reserved += pool.chunk_size;
+    }
+    pool.chunks.push_back(chunk);
+    pool.chunks_with_space.push_back(chunk);
+    pool.stats.chunk_count = pool.chunks.size();
+    return chunk;
+}
+
+void ObjectArena::releaseChunk(TypePool &pool, ChunkHeader *chunk)
+{
+    pool.chunks.erase(std::find(pool.chunks.begin(), pool.chunks.end(), chunk));
+    auto space_it = std::find(pool.chunks_with_space.begin(), pool.chunks_with_space.end(), chunk);
+    if (space_it != pool.chunks_with_space.end())
+    {
+        pool.chunks_with_space.erase(space_it);
+    }
+    pool.stats.chunk_count = pool.chunks.size();
+
+    //! reset so it can be reused as a fresh chunk
+    chunk->used_count = 0;
+    chunk->bumped_count = 0;
+    chunk->free_list = nullptr;
+
+    if (!pool.spare_chunk)
+    {
+        pool.spare_chunk = chunk;
+        return;
+    }
+    ::operator delete(static_cast<void *>(chunk), std::align_val_t{pool.chunk_size});
+    pool.stats.chunks_released++;
+    pool.stats.bytes_reserved -= pool.chunk_size;
+}
 
 void *ObjectArena::allocateObject(int type_id)
 {
-    if (m_freelists.count(type_id) == 0)
+    if (!isRegistered(type_id))
     {
         return nullptr;
     }
+    auto &pool = *m_pools[type_id];
 
-    std::byte *list_head = m_freelists.at(type_id);
-    std::size_t obj_size = m_obj_sizes.at(type_id);
+    if (pool.chunks_with_space.empty())
+    {
+        newChunk(pool);
+    }
+    auto chunk = pool.chunks_with_space.back();
 
-    if (!list_head) //! new free spot will be placed to the right
+    void *slot;
+    if (chunk->free_list)
     {
-        if (m_max_allocated_size + obj_size < m_chunk_list.back().size())
-        {
-            m_max_allocated_size += obj_size;
-            return (m_chunk_list.back().data() + (m_max_allocated_size - obj_size));
-        }
-        else //! new obj does not fit inside last chunk -> allocate new chunk
-        {
-            std::size_t prev_chunk_size = m_chunk_list.back().size();
-            m_chunk_list.emplace_back(prev_chunk_size * 2); //! increase size by a factor
-            m_max_allocated_size = obj_size;
-            return m_chunk_list.back().data();
-        }
+        slot = chunk->free_list;
+        chunk->free_list = chunk->free_list->next;
+    }
+    else
+    {
+        slot = reinterpret_cast<std::byte *>(chunk) + pool.first_slot_offset + chunk->bumped_count * pool.slot_size;
+        chunk->bumped_count++;
+    }
+    chunk->used_count++;
+    if (!hasSpace(pool, chunk))
+    {
+        pool.chunks_with_space.pop_back();
     }
 
-    auto next_head = *(reinterpret_cast<std::byte **>(list_head));
-    m_freelists.at(type_id) = next_head;
+    pool.stats.allocation_count++;
+    pool.stats.live_count++;
+    pool.stats.peak_live_count = std::max(pool.stats.peak_live_count, pool.stats.live_count);
+    return slot;
+}
+
+void ObjectArena::deallocateObject(int type_id, void *obj)
+{
+    assert(isRegistered(type_id));
+    auto &pool = *m_pools[type_id];
+
+    auto address = reinterpret_cast<std::uintptr_t>(obj);
+    auto chunk = reinterpret_cast<ChunkHeader *>(address & ~(static_cast<std::uintptr_t>(pool.chunk_size) - 1));
+    assert(chunk->pool == &pool);
 
-    return list_head;
-} */
\ No newline at end of file
+    bool was_full = !hasSpace(pool, chunk);
+    auto slot = static_cast<FreeSlot *>(obj);
+    slot->next = chunk->free_list;
+    chunk->free_list = slot;
+    chunk->used_count--;
+
+    pool.stats.deallocation_count++;
+    pool.stats.live_count--;
+
+    if (chunk->used_count == 0)
+    {
+        releaseChunk(pool, chunk);
+    }
+    else if (was_full)
+    {
+        pool.chunks_with_space.push_back(chunk);
+    }
+}
+
+ObjectArena::Stats ObjectArena::getStats(int type_id) const
+{
+    if (!isRegistered(type_id))
+    {
+        return {};
+    }
+    return m_pools[type_id]->stats;
+}
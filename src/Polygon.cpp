@@ -23,30 +23,25 @@ Polygon::Polygon(int n_points, utils::Vector2f at) : points(n_points)
 
 std::vector<utils::Vector2f> Polygon::getPointsInWorld() const
 {
-  auto n_points = points.size();
-  std::vector<utils::Vector2f> world_points(n_points);
-  //! scaling
-  for (int i = 0; i < n_points; ++i)
-  {
-    world_points[i] =  {points[i].x * getScale().x, points[i].y * getScale().y};
-  }
-  //! rotation
-  for (int i = 0; i < n_points; ++i)
-  {
-    float angle_rads = glm::radians(getRotation());
-    world_points[i] =
-        {
-          world_points[i].x * glm::cos(angle_rads) - world_points[i].y * glm::sin(angle_rads),
-          world_points[i].x * glm::sin(angle_rads) + world_points[i].y * glm::cos(angle_rads),
-        };
-  }
-  //! translation
-  for (int i = 0; i < n_points; ++i)
+  std::vector<utils::Vector2f> world_points(points.size());
+  writePointsInWorld(world_points);
+  return world_points;
+}
+
+void Polygon::writePointsInWorld(std::span<utils::Vector2f> world_points) const
+{
+  assert(world_points.size() == points.size());
+  const auto scale = getScale();
+  const auto pos = getPosition();
+  const float angle_rads = glm::radians(getRotation());
+  const float cos_a = glm::cos(angle_rads);
+  const float sin_a = glm::sin(angle_rads);
+  for (std::size_t i = 0; i < points.size(); ++i)
   {
-    world_points[i] +=  getPosition();
+    utils::Vector2f scaled = {points[i].x * scale.x, points[i].y * scale.y};
+    world_points[i] = {scaled.x * cos_a - scaled.y * sin_a + pos.x,
+                       scaled.x * sin_a + scaled.y * cos_a + pos.y};
   }
-
-  return world_points;
 }
 
 void Polygon::move(utils::Vector2f by)
@@ -0,0 +1,158 @@
+#include "SceneHierarchy.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "GameObject.h"
+
+bool SceneHierarchy::contains(int entity_id) const
+{
+    return entity_id >= 0 && entity_id < static_cast<int>(m_id2pos.size()) && m_id2pos[entity_id] != -1;
+}
+
+const std::vector<GameObject *> &SceneHierarchy::order() const
+{
+    return m_order;
+}
+
+void SceneHierarchy::setParentOf(int entity_id, int parent_id)
+{
+    if (entity_id >= static_cast<int>(m_id2pos.size()))
+    {
+        m_id2pos.resize(entity_id + 1, -1);
+        m_id2parent.resize(entity_id + 1, -1);
+    }
+    m_id2parent[entity_id] = parent_id;
+}
+
+//! positions of objects in [begin, end) changed
+void SceneHierarchy::fixPositions(std::size_t begin, std::size_t end)
+{
+    for (std::size_t pos = begin; pos < end; ++pos)
+    {
+        m_id2pos[m_order[pos]->getId()] = pos;
+    }
+}
+
+void SceneHierarchy::addToAncestors(int parent_id, long long delta)
+{
+    while (parent_id != -1)
+    {
+        m_subtree_sizes[m_id2pos[parent_id]] += delta;
+        parent_id = m_id2parent[parent_id];
+    }
+}
+
+void SceneHierarchy::insert(GameObject &object)
+{
+    auto id = object.getId();
+    if (contains(id))
+    {
+        return;
+    }
+
+    int parent_id = object.m_parent && contains(object.m_parent->getId()) ? object.m_parent->getId() : -1;
+    setParentOf(id, parent_id);
+
+    std::size_t pos = m_order.size();
+    if (parent_id != -1)
+    {
+        pos = m_id2pos[parent_id] + m_subtree_sizes[m_id2pos[parent_id]];
+    }
+    m_order.insert(m_order.begin() + pos, &object);
+    m_subtree_sizes.insert(m_subtree_sizes.begin() + pos, 1);
+    fixPositions(pos, m_order.size());
+    addToAncestors(parent_id, 1);
+
+    //! children which got in before us
+    for (auto p_child : object.m_children)
+    {
+        if (contains(p_child->getId()))
+        {
+            reattach(*p_child);
+        }
+    }
+}
+
+void SceneHierarchy::reattach(GameObject &object)
+{
+    auto id = object.getId();
+    assert(contains(id));
+
+    int new_parent_id = object.m_parent && contains(object.m_parent->getId()) ? object.m_parent->getId() : -1;
+    if (new_parent_id == m_id2parent[id])
+    {
+        return;
+    }
+
+    const std::size_t pos = m_id2pos[id];
+    const std::size_t size = m_subtree_sizes[pos];
+    assert(new_parent_id == -1 || m_id2pos[new_parent_id] < pos || m_id2pos[new_parent_id] >= pos + size);
+
+    //! computed before the old ancestors shrink, the new parent may be one of them
+    std::size_t dest = m_order.size();
+    if (new_parent_id != -1)
+    {
+        dest = m_id2pos[new_parent_id] + m_subtree_sizes[m_id2pos[new_parent_id]];
+    }
+
+    addToAncestors(m_id2parent[id], -static_cast<long long>(size));
+    m_id2parent[id] = -1; //! the subtree is on its own while moving
+
+    //! the subtree ends up right after the subtree of the new parent
+    if (dest > pos)
+    {
+        std::rotate(m_order.begin() + pos, m_order.begin() + pos + size, m_order.begin() + dest);
+        std::rotate(m_subtree_sizes.begin() + pos, m_subtree_sizes.begin() + pos + size, m_subtree_sizes.begin() + dest);
+        fixPositions(pos, dest);
+    }
+    else
+    {
+        std::rotate(m_order.begin() + dest, m_order.begin() + pos, m_order.begin() + pos + size);
+        std::rotate(m_subtree_sizes.begin() + dest, m_subtree_sizes.begin() + pos, m_subtree_sizes.begin() + pos + size);
+        fixPositions(dest, pos + size);
+    }
+
+    m_id2parent[id] = new_parent_id;
+    addToAncestors(new_parent_id, static_cast<long long>(size));
+}
+
+void SceneHierarchy::markSubtreeForRemoval(GameObject &object, std::vector<GameObject *> &removed)
+{
+    if (!contains(object.getId()))
+    {
+        return;
+    }
+    const std::size_t pos = m_id2pos[object.getId()];
+    const std::size_t end = pos + m_subtree_sizes[pos];
+    for (std::size_t i = end; i-- > pos;)
+    {
+        if (auto p_object = m_order[i])
+        {
+            removed.push_back(p_object);
+            m_id2pos[p_object->getId()] = -1;
+            m_order[i] = nullptr;
+        }
+    }
+}
+
+void SceneHierarchy::compact()
+{
+    m_order.erase(std::remove(m_order.begin(), m_order.end(), nullptr), m_order.end());
+    fixPositions(0, m_order.size());
+
+    //! removed objects might have been in the middle of subtrees so the sizes are counted again from the leaves
+    m_subtree_sizes.assign(m_order.size(), 1);
+    for (std::size_t pos = m_order.size(); pos-- > 0;)
+    {
+        auto parent_id = m_id2parent[m_order[pos]->getId()];
+        if (parent_id != -1 && contains(parent_id))
+        {
+            m_subtree_sizes[m_id2pos[parent_id]] += m_subtree_sizes[pos];
+        }
+        else
+        {
+            m_id2parent[m_order[pos]->getId()] = -1; //! the parent was removed
+        }
+    }
+}
@@ -34,6 +34,11 @@ void HealthSystem::postUpdate(float dt, EntityRegistryT &entities)
     }
 }
 
+SystemAccess HealthSystem::getAccess() const
+{
+    return SystemAccess{}.write<HealthComponent, GameObject>();
+}
+
 void HealthSystem::update(float dt)
 {
     auto comp_count = m_components.data.size();
@@ -5,8 +5,8 @@
 #include "Particles.h"
 #include "../Components.h"
 
-PathSystem::PathSystem(utils::ContiguousColony<PathComponent, int> &sprites, LayersHolder &layers)
-    : m_components(sprites), m_layers(layers)
+PathSystem::PathSystem(utils::ContiguousColony<PathComponent, int> &sprites, TransformStore &transforms, LayersHolder &layers)
+    : m_components(sprites), m_transforms(transforms), m_layers(layers)
 {
 }
 
@@ -18,7 +18,7 @@ void PathSystem::preUpdate(float dt, EntityRegistryT &entities)
     {
         auto &p_entity = entities.at(ids[comp_id]);
         auto &comp = comps[comp_id];
-        auto pos = p_entity->getPosition();
+        auto pos = m_transforms.worldPosition(ids[comp_id]);
         int current_step = comp.current_step;
         const auto &step = comp.path.steps.at(current_step);
         auto target_pos = step.target;
@@ -39,6 +39,11 @@ void PathSystem::preUpdate(float dt, EntityRegistryT &entities)
 void PathSystem::postUpdate(float dt, EntityRegistryT &entities)
 {
 }
+//! PathComponent::on_reaching_end may do anything to the world, so the system always runs alone
+SystemAccess PathSystem::getAccess() const
+{
+    return SystemAccess::makeExclusive();
+}
 void PathSystem::update(float dt)
 {
     auto &comps = m_components.data;
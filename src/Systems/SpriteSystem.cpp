@@ -3,34 +3,49 @@
 #include "Renderer.h"
 #include "DrawLayer.h"
 #include "Particles.h"
+#include "Utils/ColonyView.h"
 
-SpriteSystem::SpriteSystem(utils::ContiguousColony<SpriteComponent, int> &sprites, LayersHolder &layers)
-    : m_components(sprites), m_layers(layers)
+SpriteSystem::SpriteSystem(utils::ContiguousColony<SpriteComponent, int> &sprites, TransformStore &transforms, LayersHolder &layers)
+    : m_components(sprites), m_transforms(transforms), m_layers(layers)
 {
 }
 
 void SpriteSystem::preUpdate(float dt, EntityRegistryT &entities)
 {
     auto &comps = m_components.data;
-    auto &ids = m_components.data_ind2id;
-    for (std::size_t comp_id = 0; comp_id < comps.size(); ++comp_id)
-    {
-        auto &comp = comps[comp_id];
-        comp.sprite.setPosition(entities.at(ids[comp_id])->getPosition());
-        comp.sprite.setRotation(utils::radians(entities.at(ids[comp_id])->getAngle()));
-        comp.sprite.setScale(entities.at(ids[comp_id])->getSize() / 2.f);
-    }
+    auto &versions = m_components.data_versions;
+    //! every task writes only its own sprites and reads the transforms, so no synchronization is needed
+    utils::parallelForEach(p_pool, m_components, [&](int id, SpriteComponent &comp)
+                           {
+        auto comp_id = &comp - comps.data();
+        //! only sprites of entities which moved and newly added sprites need to be refreshed
+        if (versions[comp_id] <= m_seen_components_version && !m_transforms.changedSince(id, m_seen_transforms_version))
+        {
+            return;
+        }
+        comp.sprite.setPosition(m_transforms.worldPosition(id));
+        comp.sprite.setRotation(utils::radians(m_transforms.worldAngle(id)));
+        comp.sprite.setScale(m_transforms.size(id) / 2.f); });
+    m_seen_components_version = m_components.currentVersion();
+    m_seen_transforms_version = m_transforms.currentVersion();
 }
 void SpriteSystem::postUpdate(float dt, EntityRegistryT &entities)
 {
 }
+SystemAccess SpriteSystem::getAccess() const
+{
+    return SystemAccess{}.read<TransformStore>().write<SpriteComponent>();
+}
 void SpriteSystem::update(float dt)
 {
-    auto &comps = m_components.data;
-    auto &ids = m_components.data_ind2id;
-    for (std::size_t comp_id = 0; comp_id < comps.size(); ++comp_id)
+}
+void SpriteSystem::draw()
+{
+    for (auto [id, comp] : utils::ColonyView(m_components))
     {
-        auto &comp = comps[comp_id];
+        //! the transforms may be interpolated between steps right now, so the pose is taken again
+        comp.sprite.setPosition(m_transforms.worldPosition(id));
+        comp.sprite.setRotation(utils::radians(m_transforms.worldAngle(id)));
         auto &canvas = m_layers.getCanvas(comp.layer_id);
         canvas.drawSprite(comp.sprite, comp.shader_id);
     }
@@ -75,43 +90,41 @@ void ParticleSystem::update(float dt)
     }
 } */
 
-TransformSystem::TransformSystem(utils::ContiguousColony<TransformComponent, int> &sprites)
-    : m_components(sprites)
+TransformSystem::TransformSystem(utils::ContiguousColony<TransformComponent, int> &sprites, TransformStore &transforms)
+    : m_components(sprites), m_transforms(transforms)
 {
 }
 
 void TransformSystem::preUpdate(float dt, EntityRegistryT &entities)
 {
-    std::vector<int> to_destroy;
-
-    auto &comps = m_components.data;
-    auto &ids = m_components.data_ind2id;
-    for (std::size_t comp_id = 0; comp_id < comps.size(); ++comp_id)
-    {
-        auto &comp = comps[comp_id];
-
-        auto &entity = entities.at(ids[comp_id]);
-        auto pos = entity->getPosition();
-        float dist2 = utils::norm2(comp.target_pos - pos);
+    //! positions are only computed in parallel, writing them could race with reading positions of parents
+    m_moves.prepare(p_pool);
+    m_to_destroy.prepare(p_pool);
+    utils::parallelForEach(p_pool, m_components, [&](int id, TransformComponent &comp)
+                           {
+        auto pos = m_transforms.worldPosition(id);
         if(comp.duration > 0.f)
         {
-            entity->setPosition(pos + dt / comp.duration * (comp.target_pos - pos));
+            m_moves.push({id, pos + dt / comp.duration * (comp.target_pos - pos)});
             comp.duration -= dt;
         }else{
-            to_destroy.push_back(ids[comp_id]);
-        }
-        // comp.sprite.setRotation(utils::radians(entities.at(ids[comp_id])->getAngle()));
-        // comp.sprite.setScale(entities.at(ids[comp_id])->getSize()/2.f);
-    }
+            m_to_destroy.push(id);
+        } });
 
-    while(!to_destroy.empty())
-    {
-        m_components.erase(to_destroy.back());
-        to_destroy.pop_back();
-    }
+    m_moves.flush([this](const auto &move)
+                  {
+        m_transforms.position(move.first) = move.second;
+        m_transforms.markChanged(move.first); });
+    m_to_destroy.flush([this](int id)
+                       { m_components.erase(id); });
 }
 void TransformSystem::update(float dt) {}
 
+SystemAccess TransformSystem::getAccess() const
+{
+    return SystemAccess{}.write<TransformComponent, TransformStore>();
+}
+
 void TransformSystem::postUpdate(float dt, EntityRegistryT &entities)
 {
 }
\ No newline at end of file
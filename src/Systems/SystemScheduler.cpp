@@ -0,0 +1,113 @@
+#include "SystemScheduler.h"
+
+#include <algorithm>
+
+#include "Utils/ThreadPool.h"
+
+void SystemScheduler::add(std::shared_ptr<SystemI> p_system)
+{
+    p_system->setThreadPool(p_pool);
+    std::type_index type = typeid(*p_system);
+    auto it = std::find(m_system_types.begin(), m_system_types.end(), type);
+    if (it != m_system_types.end())
+    {
+        auto ind = std::distance(m_system_types.begin(), it);
+        m_systems.at(ind) = p_system;
+        m_accesses.at(ind) = p_system->getAccess();
+    }
+    else
+    {
+        m_systems.push_back(p_system);
+        m_system_types.push_back(type);
+        m_accesses.push_back(p_system->getAccess());
+    }
+    m_batches_dirty = true;
+}
+
+void SystemScheduler::setThreadPool(utils::ThreadPool *pool)
+{
+    p_pool = pool;
+    for (auto &p_system : m_systems)
+    {
+        p_system->setThreadPool(pool);
+    }
+}
+
+const std::vector<std::vector<std::size_t>> &SystemScheduler::getBatches()
+{
+    if (m_batches_dirty)
+    {
+        rebuildBatches();
+    }
+    return m_batches;
+}
+
+//! the batch of a system is one after the last batch of any earlier system it conflicts with
+void SystemScheduler::rebuildBatches()
+{
+    const auto n_systems = m_systems.size();
+    std::vector<std::size_t> system2batch(n_systems, 0);
+    std::size_t n_batches = 0;
+    for (std::size_t i = 0; i < n_systems; ++i)
+    {
+        for (std::size_t prev = 0; prev < i; ++prev)
+        {
+            if (m_accesses[i].conflictsWith(m_accesses[prev]))
+            {
+                system2batch[i] = std::max(system2batch[i], system2batch[prev] + 1);
+            }
+        }
+        n_batches = std::max(n_batches, system2batch[i] + 1);
+    }
+
+    m_batches.assign(n_batches, {});
+    for (std::size_t i = 0; i < n_systems; ++i)
+    {
+        m_batches[system2batch[i]].push_back(i);
+    }
+    m_batches_dirty = false;
+}
+
+template <class SystemCall>
+void SystemScheduler::runBatches(SystemCall &&call)
+{
+    for (auto &batch : getBatches())
+    {
+        if (!p_pool || batch.size() == 1)
+        {
+            for (auto system_ind : batch)
+            {
+                call(*m_systems[system_ind]);
+            }
+            continue;
+        }
+        p_pool->parallelFor(batch.size(), [&](std::size_t i)
+                            { call(*m_systems[batch[i]]); });
+    }
+}
+
+void SystemScheduler::preUpdate(float dt, EntityRegistryT &entities)
+{
+    runBatches([dt, &entities](SystemI &system)
+               { system.preUpdate(dt, entities); });
+}
+
+void SystemScheduler::update(float dt)
+{
+    runBatches([dt](SystemI &system)
+               { system.update(dt); });
+}
+
+void SystemScheduler::postUpdate(float dt, EntityRegistryT &entities)
+{
+    runBatches([dt, &entities](SystemI &system)
+               { system.postUpdate(dt, entities); });
+}
+
+void SystemScheduler::draw()
+{
+    for (auto &p_system : m_systems)
+    {
+        p_system->draw();
+    }
+}
@@ -99,4 +99,9 @@ TimedEventId TimedEventManager::runDelayed(std::function<void()> callback, float
 void TimedEventManager::clear()
 {
     m_events.clear();
+}
+
+bool TimedEventManager::isEmpty()
+{
+    return m_events.getData().empty();
 }
\ No newline at end of file
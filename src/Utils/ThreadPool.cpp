@@ -0,0 +1,247 @@
+#include "ThreadPool.h"
+
+namespace utils
+{
+
+    namespace
+    {
+        thread_local std::size_t t_thread_ind = 0;
+        thread_local bool t_inside_task = false;
+    }
+
+    void ThreadPool::setEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    bool ThreadPool::isEnabled() const
+    {
+        return m_enabled;
+    }
+
+    std::size_t ThreadPool::participantCount() const
+    {
+        return workerCount() + 1;
+    }
+
+    std::size_t ThreadPool::currentThreadIndex()
+    {
+        return t_thread_ind;
+    }
+
+#if defined(__EMSCRIPTEN__)
+
+    ThreadPool::ThreadPool(std::size_t n_workers)
+    {
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+    }
+
+    void ThreadPool::parallelFor(std::size_t n_tasks, const std::function<void(std::size_t)> &task)
+    {
+        for (std::size_t i = 0; i < n_tasks; ++i)
+        {
+            task(i);
+        }
+    }
+
+    std::size_t ThreadPool::workerCount() const
+    {
+        return 0;
+    }
+
+    std::size_t ThreadPool::defaultWorkerCount()
+    {
+        return 0;
+    }
+
+#else
+
+    ThreadPool::ThreadPool(std::size_t n_workers)
+    {
+        for (std::size_t i = 0; i < n_workers + 1; ++i)
+        {
+            m_ranges.push_back(std::make_unique<WorkRange>());
+        }
+        m_workers.reserve(n_workers);
+        for (std::size_t i = 0; i < n_workers; ++i)
+        {
+            m_workers.emplace_back([this, i]()
+                                   { workerLoop(i + 1); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake_workers.notify_all();
+        for (auto &worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::workerCount() const
+    {
+        return m_workers.size();
+    }
+
+    std::size_t ThreadPool::defaultWorkerCount()
+    {
+        auto n_cores = std::thread::hardware_concurrency();
+        return n_cores > 1 ? n_cores - 1 : 0; //! the calling thread also works
+    }
+
+    void ThreadPool::parallelFor(std::size_t n_tasks, const std::function<void(std::size_t)> &task)
+    {
+        //! nested calls would overwrite the running batch, so they are run by the thread which made them
+        if (m_workers.empty() || !m_enabled || t_inside_task || n_tasks <= 1)
+        {
+            for (std::size_t i = 0; i < n_tasks; ++i)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            p_task = &task;
+            m_task_count = n_tasks;
+            m_finished_count = 0;
+            m_exception = nullptr;
+            m_batch_id++;
+
+            //! every participant starts with an equal contiguous part of the batch
+            auto n_ranges = m_ranges.size();
+            for (std::size_t i = 0; i < n_ranges; ++i)
+            {
+                std::lock_guard range_lock(m_ranges[i]->mutex);
+                m_ranges[i]->begin = n_tasks * i / n_ranges;
+                m_ranges[i]->end = n_tasks * (i + 1) / n_ranges;
+            }
+        }
+        m_wake_workers.notify_all();
+
+        runTasks(task, 0);
+
+        std::unique_lock lock(m_mutex);
+        //! wait also for the workers to leave, so that no one touches the task after we return
+        m_batch_done.wait(lock, [this]()
+                          { return m_finished_count == m_task_count && m_active_workers == 0; });
+        p_task = nullptr;
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    bool ThreadPool::popTask(std::size_t thread_ind, std::size_t &task_ind)
+    {
+        auto &range = *m_ranges[thread_ind];
+        std::lock_guard lock(range.mutex);
+        if (range.begin < range.end)
+        {
+            task_ind = range.begin++;
+            return true;
+        }
+        return false;
+    }
+
+    //! takes the back half of the remaining tasks of some other thread
+    bool ThreadPool::stealTask(std::size_t thread_ind, std::size_t &task_ind)
+    {
+        auto n_ranges = m_ranges.size();
+        for (std::size_t offset = 1; offset < n_ranges; ++offset)
+        {
+            auto &victim = *m_ranges[(thread_ind + offset) % n_ranges];
+            std::size_t stolen_begin, stolen_end;
+            {
+                std::lock_guard lock(victim.mutex);
+                if (victim.begin >= victim.end)
+                {
+                    continue;
+                }
+                stolen_end = victim.end;
+                stolen_begin = victim.begin + (victim.end - victim.begin) / 2;
+                victim.end = stolen_begin;
+            }
+
+            //! our range is empty so nobody else touches it in the meantime
+            auto &own = *m_ranges[thread_ind];
+            std::lock_guard lock(own.mutex);
+            own.begin = stolen_begin + 1;
+            own.end = stolen_end;
+            task_ind = stolen_begin;
+            return true;
+        }
+        return false;
+    }
+
+    //! runs tasks of the current batch until there are none left anywhere
+    void ThreadPool::runTasks(const std::function<void(std::size_t)> &task, std::size_t thread_ind)
+    {
+        std::size_t finished = 0;
+        std::exception_ptr exception;
+        t_inside_task = true;
+        std::size_t task_ind;
+        while (popTask(thread_ind, task_ind) || stealTask(thread_ind, task_ind))
+        {
+            try
+            {
+                task(task_ind);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+            finished++;
+        }
+        t_inside_task = false;
+
+        std::lock_guard lock(m_mutex);
+        if (exception && !m_exception)
+        {
+            m_exception = exception;
+        }
+        m_finished_count += finished;
+    }
+
+    void ThreadPool::workerLoop(std::size_t thread_ind)
+    {
+        t_thread_ind = thread_ind;
+        std::size_t last_batch = 0;
+        while (true)
+        {
+            const std::function<void(std::size_t)> *task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake_workers.wait(lock, [this, last_batch]()
+                                    { return m_stopping || (p_task && m_batch_id != last_batch); });
+                if (m_stopping)
+                {
+                    return;
+                }
+                last_batch = m_batch_id;
+                task = p_task;
+                m_active_workers++;
+            }
+
+            runTasks(*task, thread_ind);
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_active_workers--;
+            }
+            m_batch_done.notify_one();
+        }
+    }
+
+#endif
+
+} //! namespace utils
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+
+#include "Time.h"
+
+//! best time in milliseconds of a few runs of fn, so that a single hiccup of the machine does not count
+template <class Fn>
+double measureMs(Fn &&fn, int n_runs = 5)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < n_runs; ++run)
+    {
+        auto start = timeNow();
+        fn();
+        best = std::min(best, getDt(timeNow(), start));
+    }
+    return best;
+}
+
+//! every bench prints its timings and returns false if the checked results do not agree
+bool benchSparseIndex();
+bool benchParallelForEach();
+bool benchUpdateBatches();
+bool benchCollisionKernel();
+bool benchSnapshot();
+bool benchSpatialSort();
+//! checks without timings
+bool checkDelayedComponents();
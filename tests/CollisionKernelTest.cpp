@@ -0,0 +1,144 @@
+#include "Bench.h"
+
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <limits>
+
+#include "CollisionSystem.h"
+#include "Entities/Meteor.h"
+
+namespace
+{
+    //! calcCollisionData as it was before the axes were batched, every axis projected on its own
+    CollisionData calcCollisionDataReference(std::span<const utils::Vector2f> points1, std::span<const utils::Vector2f> normals1,
+                                             std::span<const utils::Vector2f> points2, std::span<const utils::Vector2f> normals2)
+    {
+        CollisionData collision_result;
+        float min_overlap = std::numeric_limits<float>::max();
+        auto check_axes = [&](std::span<const utils::Vector2f> axes, bool axes_belong_to_a)
+        {
+            for (auto n : axes)
+            {
+                if (n.x == 0.f && n.y == 0.f)
+                {
+                    continue;
+                }
+                auto proj1 = projectOnAxis(n, points1);
+                auto proj2 = projectOnAxis(n, points2);
+                if (!overlap1D(proj1, proj2))
+                {
+                    return false;
+                }
+                auto overlap = calcOverlap(proj1, proj2);
+                if (utils::approx_equal_zero(overlap))
+                {
+                    continue;
+                }
+                if (overlap < min_overlap)
+                {
+                    min_overlap = overlap;
+                    collision_result.separation_axis = n;
+                    collision_result.belongs_to_a = axes_belong_to_a;
+                }
+            }
+            return true;
+        };
+        if (!check_axes(normals1, true) || !check_axes(normals2, false))
+        {
+            collision_result.minimum_translation = -1;
+            return collision_result;
+        }
+        collision_result.minimum_translation = min_overlap;
+        return collision_result;
+    }
+
+    struct WorldShape
+    {
+        std::vector<utils::Vector2f> points;
+        std::vector<utils::Vector2f> normals;
+    };
+
+    //! meteors as Meteor::initializeRandomMeteor makes them, packed into a small box so that many of them overlap
+    std::vector<WorldShape> makeMeteors(int n_meteors)
+    {
+        std::mt19937 gen(22);
+        std::uniform_real_distribution<float> pos_dist(0.f, 200.f);
+        std::uniform_real_distribution<float> radius_dist(10.f, 40.f);
+        std::uniform_real_distribution<float> angle_dist(0.f, 360.f);
+
+        std::vector<WorldShape> meteors(n_meteors);
+        for (auto &meteor : meteors)
+        {
+            auto polygon = generateRandomConvexPolygon(12 + std::rand() % 3);
+            auto radius = radius_dist(gen);
+            polygon.setScale(radius, radius);
+            polygon.setPosition(pos_dist(gen), pos_dist(gen));
+            polygon.setRotation(angle_dist(gen));
+
+            meteor.points = polygon.getPointsInWorld();
+            meteor.normals.resize(meteor.points.size());
+            Collisions::computeEdgeNormals(meteor.points, meteor.normals);
+        }
+        return meteors;
+    }
+
+    bool areSame(const CollisionData &a, const CollisionData &b)
+    {
+        return a.minimum_translation == b.minimum_translation && a.belongs_to_a == b.belongs_to_a &&
+               a.separation_axis.x == b.separation_axis.x && a.separation_axis.y == b.separation_axis.y &&
+               a.contact_point.x == b.contact_point.x && a.contact_point.y == b.contact_point.y;
+    }
+} //! namespace
+
+//! the batched SAT kernel must give exactly the CollisionData of the per-axis one
+bool benchCollisionKernel()
+{
+    constexpr int N_METEORS = 512;
+    std::srand(22);
+    auto meteors = makeMeteors(N_METEORS);
+
+    bool ok = true;
+    int n_colliding = 0;
+    for (int i = 0; i < N_METEORS; ++i)
+    {
+        for (int j = i + 1; j < N_METEORS; ++j)
+        {
+            auto &a = meteors[i];
+            auto &b = meteors[j];
+            auto batched = Collisions::calcCollisionData(a.points, a.normals, b.points, b.normals);
+            auto reference = calcCollisionDataReference(a.points, a.normals, b.points, b.normals);
+            ok &= areSame(batched, reference);
+            n_colliding += reference.minimum_translation > 0.f;
+        }
+    }
+
+    float batched_sum = 0.f;
+    float reference_sum = 0.f;
+    auto time_all_pairs = [&](auto &&calc, float &sum)
+    {
+        return measureMs([&]
+                         {
+            sum = 0.f;
+            for (int i = 0; i < N_METEORS; ++i)
+            {
+                for (int j = i + 1; j < N_METEORS; ++j)
+                {
+                    sum += calc(meteors[i].points, meteors[i].normals, meteors[j].points, meteors[j].normals).minimum_translation;
+                }
+            } });
+    };
+    auto batched_ms = time_all_pairs(Collisions::calcCollisionData, batched_sum);
+    auto reference_ms = time_all_pairs(calcCollisionDataReference, reference_sum);
+    ok &= batched_sum == reference_sum;
+
+    const int n_pairs = N_METEORS * (N_METEORS - 1) / 2;
+#if defined(__SSE2__)
+    const char *kernel = "SSE2";
+#else
+    const char *kernel = "scalar";
+#endif
+    std::printf("calcCollisionData: %d meteor pairs (%d colliding), batched axes (%s) %.2f ms, one axis at a time %.2f ms %s\n",
+                n_pairs, n_colliding, kernel, batched_ms, reference_ms, ok ? "" : "MISMATCH");
+    return ok;
+}
@@ -0,0 +1,45 @@
+#include "Bench.h"
+
+#include "Systems/System.h"
+
+namespace
+{
+    struct Counter
+    {
+        int value = 0;
+    };
+} //! namespace
+
+//! ComponentHolder::applyWaiting keeps for every entity only the last recorded add or remove
+bool checkDelayedComponents()
+{
+    ComponentHolder<Counter> holder;
+    holder.add({1}, 0);
+    holder.add({1}, 1);
+    holder.add({1}, 2);
+
+    holder.eraseDelayed(0);
+    holder.addDelayed({2}, 0); //! remove then add: replaced by the added one
+    holder.addDelayed({2}, 1);
+    holder.eraseDelayed(1); //! add then remove: gone
+    holder.addDelayed({2}, 3);
+    holder.addDelayed({3}, 3); //! the last add wins
+    holder.eraseDelayed(4);    //! removing a missing component does nothing
+    holder.eraseDelayed(2);
+    holder.eraseDelayed(2);
+    holder.applyWaiting();
+
+    bool ok = holder.has(0) && holder.get(0).value == 2;
+    ok &= !holder.has(1);
+    ok &= !holder.has(2);
+    ok &= holder.has(3) && holder.get(3).value == 3;
+    ok &= !holder.has(4);
+    ok &= holder.getComponents().data.size() == 2;
+
+    //! nothing left over for the next frame
+    holder.applyWaiting();
+    ok &= holder.has(0) && holder.has(3) && holder.getComponents().data.size() == 2;
+
+    std::printf("delayed components: %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
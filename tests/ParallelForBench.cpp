@@ -0,0 +1,87 @@
+#include "Bench.h"
+
+#include <cmath>
+#include <vector>
+#include <thread>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    struct Particle
+    {
+        float x = 0.f;
+        float y = 0.f;
+        float vx = 1.f;
+        float vy = 0.f;
+        float life = 1.f;
+    };
+
+    //! some arithmetic per datum, roughly what the particle and movement systems do
+    void integrate(Particle &p, float dt)
+    {
+        for (int sub_step = 0; sub_step < 8; ++sub_step)
+        {
+            auto speed = std::sqrt(p.vx * p.vx + p.vy * p.vy);
+            auto drag = 1.f / (1.f + 0.1f * speed * dt);
+            p.vx = p.vx * drag + std::sin(p.y) * dt;
+            p.vy = p.vy * drag + std::cos(p.x) * dt;
+            p.x += p.vx * dt;
+            p.y += p.vy * dt;
+        }
+        p.life -= dt;
+    }
+
+    utils::ContiguousColony<Particle, int> makeParticles(int n_particles)
+    {
+        utils::ContiguousColony<Particle, int> particles;
+        for (int id = 0; id < n_particles; ++id)
+        {
+            particles.insert(id, Particle{static_cast<float>(id % 100), static_cast<float>(id / 100), 1.f, 0.f, 1.f});
+        }
+        return particles;
+    }
+} //! namespace
+
+//! the same update of a colony on pools of growing size, results must not depend on the number of threads
+bool benchParallelForEach()
+{
+    constexpr int N_PARTICLES = 200000;
+    constexpr float DT = 1.f / 60.f;
+
+    auto reference = makeParticles(N_PARTICLES);
+    auto serial_ms = measureMs([&]
+                               { utils::parallelForEach(nullptr, reference, [](int, Particle &p)
+                                                        { integrate(p, DT); }); }, 1);
+
+    bool ok = true;
+    std::printf("parallelForEach: %d data, serial %.2f ms\n", N_PARTICLES, serial_ms);
+    //! doubling up to all hardware threads (the caller counts as one), which is always measured as well
+    //! at least a few workers even on small machines, so that the results are checked with real threads
+    const std::size_t max_workers = std::max(4u, std::thread::hardware_concurrency()) - 1;
+    std::vector<std::size_t> worker_counts;
+    for (std::size_t n_workers = 1; n_workers < max_workers; n_workers *= 2)
+    {
+        worker_counts.push_back(n_workers);
+    }
+    worker_counts.push_back(max_workers);
+    for (auto n_workers : worker_counts)
+    {
+        utils::ThreadPool pool(n_workers);
+        auto particles = makeParticles(N_PARTICLES);
+        auto ms = measureMs([&]
+                            { utils::parallelForEach(&pool, particles, [](int, Particle &p)
+                                                     { integrate(p, DT); }); }, 1);
+
+        bool same = particles.data.size() == reference.data.size();
+        for (std::size_t i = 0; same && i < particles.data.size(); ++i)
+        {
+            same = particles.data[i].x == reference.data[i].x && particles.data[i].y == reference.data[i].y &&
+                   particles.data[i].life == reference.data[i].life;
+        }
+        ok &= same;
+        std::printf("    %zu threads: %.2f ms, speedup %.2f %s\n", pool.participantCount(), ms, serial_ms / ms,
+                    same ? "" : "MISMATCH");
+    }
+    return ok;
+}
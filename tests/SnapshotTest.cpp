@@ -0,0 +1,120 @@
+#include "Bench.h"
+
+#include <vector>
+#include <random>
+
+#include "GameWorld.h"
+
+namespace
+{
+    struct SavedEntity
+    {
+        int id;
+        utils::Vector2f pos;
+        float angle;
+        utils::Vector2f size;
+        float hp;
+        int frame_id;
+        std::string animation_id;
+        int path_step;
+    };
+
+    bool areSame(utils::Vector2f a, utils::Vector2f b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+
+    //! compares the live state of the world with the values it had when the snapshot was taken
+    bool matches(GameWorld &world, const std::vector<SavedEntity> &saved)
+    {
+        auto &transforms = world.getTransforms();
+        auto &healths = world.m_systems.getComponents<HealthComponent>();
+        auto &animations = world.m_systems.getComponents<AnimationComponent>();
+        auto &paths = world.m_systems.getComponents<PathComponent>();
+        bool ok = healths.size() == saved.size() && animations.size() == saved.size() && paths.size() == saved.size();
+        for (auto &entity : saved)
+        {
+            ok &= areSame(transforms.position(entity.id), entity.pos);
+            ok &= transforms.angle(entity.id) == entity.angle;
+            ok &= areSame(transforms.size(entity.id), entity.size);
+            ok &= healths.contains(entity.id) && healths.get(entity.id).hp == entity.hp;
+            ok &= animations.contains(entity.id) && animations.get(entity.id).current_frame_id == entity.frame_id &&
+                  animations.get(entity.id).id == entity.animation_id;
+            ok &= paths.contains(entity.id) && paths.get(entity.id).current_step == entity.path_step;
+        }
+        return ok;
+    }
+} //! namespace
+
+//! GameWorld::saveSnapshot followed by changes and restoreSnapshot must give back the saved transforms and components
+//! health and animations go through the blob, paths (holding a callback) through the copies
+bool benchSnapshot()
+{
+    constexpr int N_ENTITIES = 5000;
+
+    PostOffice messenger;
+    GameWorld world(messenger);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(0.f, 1000.f);
+    std::vector<SavedEntity> saved;
+    for (int i = 0; i < N_ENTITIES; ++i)
+    {
+        auto &entity = world.addObject3(ObjectType::Player);
+        auto id = entity.getId();
+        entity.setPosition({dist(gen), dist(gen)});
+        entity.setAngle(dist(gen) / 1000.f * 360.f);
+        entity.setSize({1.f + dist(gen) / 100.f, 1.f + dist(gen) / 100.f});
+
+        HealthComponent health = {100.f, 1.f + dist(gen) / 10.f, 0.f};
+        AnimationComponent animation;
+        animation.id = "Explosion" + std::to_string(i % 7);
+        animation.current_frame_id = i % 13;
+        PathComponent path;
+        path.current_step = i % 5;
+        world.m_systems.add(std::move(health), id);
+        world.m_systems.add(std::move(animation), id);
+        world.m_systems.add(std::move(path), id);
+
+        saved.push_back({id, entity.getPosition(), entity.getAngle(), entity.getSize(), world.m_systems.getComponents<HealthComponent>().get(id).hp,
+                         i % 13, "Explosion" + std::to_string(i % 7), i % 5});
+    }
+
+    WorldSnapshot snapshot;
+    auto save_ms = measureMs([&]
+                             { world.saveSnapshot(snapshot); });
+
+    //! everything changes after the snapshot, including a removal which is still waiting for the end of the frame
+    auto scramble = [&]
+    {
+        auto &transforms = world.getTransforms();
+        for (auto &entity : saved)
+        {
+            transforms.position(entity.id) += utils::Vector2f{1.f, -2.f};
+            transforms.angle(entity.id) += 10.f;
+            world.m_systems.getComponents<HealthComponent>().get(entity.id).hp -= 0.5f;
+            world.m_systems.getComponents<AnimationComponent>().get(entity.id).current_frame_id++;
+            world.m_systems.getComponents<AnimationComponent>().get(entity.id).id += "x";
+            world.m_systems.getComponents<PathComponent>().get(entity.id).current_step++;
+        }
+        world.m_systems.removeDelayed<HealthComponent>(saved.front().id);
+    };
+
+    scramble();
+    bool ok = !matches(world, saved);
+    world.restoreSnapshot(snapshot);
+    //! the removal recorded before the restore must not be applied to the restored state
+    world.m_systems.postUpdate(0.f);
+    ok &= matches(world, saved);
+
+    auto restore_ms = measureMs([&]
+                                {
+        scramble();
+        world.restoreSnapshot(snapshot); });
+    world.m_systems.postUpdate(0.f);
+    ok &= matches(world, saved);
+
+    std::printf("snapshot: %d entities, %zu bytes in the blob, save %.3f ms, scramble + restore %.3f ms %s\n",
+                N_ENTITIES, snapshot.blob.size(), save_ms, restore_ms, ok ? "" : "MISMATCH");
+    return ok;
+}
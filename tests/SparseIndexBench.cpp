@@ -0,0 +1,87 @@
+#include "Bench.h"
+
+#include <vector>
+#include <unordered_map>
+#include <random>
+
+#include "ContiguousColony.h"
+
+//! lookups of the component colonies go through PagedSparseIndex, before they used an unordered_map
+namespace
+{
+    bool compareLookups(int n_ids)
+    {
+        constexpr int N_LOOKUPS = 1000000;
+
+        utils::PagedSparseIndex<int> paged;
+        std::unordered_map<int, std::size_t> map;
+        //! entities die and get born, so the live ids are spread over a larger range
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> id_dist(0, 4 * n_ids);
+        std::vector<int> ids;
+        for (int i = 0; i < n_ids; ++i)
+        {
+            auto id = id_dist(gen);
+            if (!paged.contains(id))
+            {
+                paged.set(id, ids.size());
+                map[id] = ids.size();
+                ids.push_back(id);
+            }
+        }
+
+        std::vector<int> queries(N_LOOKUPS);
+        std::uniform_int_distribution<std::size_t> ind_dist(0, ids.size() - 1);
+        for (auto &query : queries)
+        {
+            query = ids[ind_dist(gen)];
+        }
+
+        std::size_t paged_sum = 0;
+        std::size_t map_sum = 0;
+        auto paged_ms = measureMs([&]
+                                  {
+            paged_sum = 0;
+            for (auto id : queries)
+            {
+                paged_sum += paged.at(id);
+            } });
+        auto map_ms = measureMs([&]
+                                {
+            map_sum = 0;
+            for (auto id : queries)
+            {
+                map_sum += map.at(id);
+            } });
+
+        bool ok = paged_sum == map_sum;
+        for (auto id : ids)
+        {
+            ok &= paged.at(id) == map.at(id);
+        }
+        //! ids which were never inserted must be reported like unordered_map::at does
+        try
+        {
+            paged.at(8 * n_ids);
+            ok = false;
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+
+        std::printf("sparse index: %d ids, %d lookups, paged %.2f ms, unordered_map %.2f ms %s\n",
+                    n_ids, N_LOOKUPS, paged_ms, map_ms, ok ? "" : "MISMATCH");
+        return ok;
+    }
+} //! namespace
+
+//! small worlds fit into the cache either way, the difference grows with the number of entities
+bool benchSparseIndex()
+{
+    bool ok = true;
+    for (int n_ids : {1000, 10000, 100000})
+    {
+        ok &= compareLookups(n_ids);
+    }
+    return ok;
+}
@@ -0,0 +1,148 @@
+#include "Bench.h"
+
+#include <vector>
+#include <random>
+#include <array>
+#include <algorithm>
+
+#include "MortonOrder.h"
+
+//! CollisionSystem::setSpatialSorting keeps the collision colony in Z-order, the narrow phase then reads
+//! the components of close pairs (which the broad phase finds near each other) from nearby memory
+namespace
+{
+    //! about the size of a CollisionComponent with a meteor polygon, the payload is what the narrow phase reads
+    struct Collider
+    {
+        utils::Vector2f pos;
+        float radius;
+        std::array<float, 61> payload;
+    };
+
+    constexpr float CELL_SIZE = 20.f;
+
+    std::uint32_t keyOf(const utils::ContiguousColony<Collider, int> &colony, int id)
+    {
+        return utils::mortonCode(colony.get(id).pos, CELL_SIZE);
+    }
+
+    //! pairs of ids closer than the sum of their radii, in the spatial order in which a tree traversal finds them
+    std::vector<std::pair<int, int>> findClosePairs(const std::vector<Collider> &colliders, float world_size)
+    {
+        const int n_cells = static_cast<int>(world_size / CELL_SIZE) + 1;
+        std::vector<std::vector<int>> grid(n_cells * n_cells);
+        for (int id = 0; id < static_cast<int>(colliders.size()); ++id)
+        {
+            auto &pos = colliders[id].pos;
+            grid[static_cast<int>(pos.y / CELL_SIZE) * n_cells + static_cast<int>(pos.x / CELL_SIZE)].push_back(id);
+        }
+
+        std::vector<std::pair<std::uint32_t, int>> order;
+        for (int id = 0; id < static_cast<int>(colliders.size()); ++id)
+        {
+            order.push_back({utils::mortonCode(colliders[id].pos, CELL_SIZE), id});
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<std::pair<int, int>> pairs;
+        for (auto [key, id] : order)
+        {
+            auto &pos = colliders[id].pos;
+            int cx = static_cast<int>(pos.x / CELL_SIZE);
+            int cy = static_cast<int>(pos.y / CELL_SIZE);
+            for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, n_cells - 1); ++y)
+            {
+                for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, n_cells - 1); ++x)
+                {
+                    for (auto other : grid[y * n_cells + x])
+                    {
+                        auto dr = colliders[other].pos - pos;
+                        auto reach = colliders[other].radius + colliders[id].radius;
+                        if (other > id && dr.x * dr.x + dr.y * dr.y < reach * reach)
+                        {
+                            pairs.push_back({id, other});
+                        }
+                    }
+                }
+            }
+        }
+        return pairs;
+    }
+
+    //! reads both components of every pair, like the narrow phase does
+    float narrowPhase(const utils::ContiguousColony<Collider, int> &colony, const std::vector<std::pair<int, int>> &pairs)
+    {
+        float sum = 0.f;
+        for (auto [id_a, id_b] : pairs)
+        {
+            auto &a = colony.get(id_a);
+            auto &b = colony.get(id_b);
+            for (std::size_t i = 0; i < a.payload.size(); i += 4)
+            {
+                sum += a.payload[i] * b.payload[i];
+            }
+        }
+        return sum;
+    }
+} //! namespace
+
+//! the pairs must give the same result in both orders of the colony, the sorted colony must follow the keys
+bool benchSpatialSort()
+{
+    constexpr int N_COLLIDERS = 100000;
+    constexpr float WORLD_SIZE = 4000.f;
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> pos_dist(0.f, WORLD_SIZE);
+    std::uniform_real_distribution<float> radius_dist(2.f, 10.f);
+    std::vector<Collider> colliders(N_COLLIDERS);
+    for (int id = 0; id < N_COLLIDERS; ++id)
+    {
+        colliders[id].pos = {pos_dist(gen), pos_dist(gen)};
+        colliders[id].radius = radius_dist(gen);
+        colliders[id].payload.fill(static_cast<float>(id % 7) * 0.125f);
+    }
+    auto pairs = findClosePairs(colliders, WORLD_SIZE);
+
+    //! entities are created in random places, so the colony starts without any spatial order
+    utils::ContiguousColony<Collider, int> colony;
+    for (int id = 0; id < N_COLLIDERS; ++id)
+    {
+        colony.insert(id, colliders[id]);
+    }
+
+    float unsorted_sum = 0.f;
+    auto unsorted_ms = measureMs([&]
+                                 { unsorted_sum = narrowPhase(colony, pairs); });
+
+    //! the per frame cost with the default number of swaps, until one pass over the colony is done
+    utils::IncrementalSorter sorter;
+    constexpr int N_STEPS = 100;
+    auto step_ms = measureMs([&]
+                             {
+        for (int step = 0; step < N_STEPS; ++step)
+        {
+            sorter.step(colony, [&](int id)
+                        { return keyOf(colony, id); });
+        } }, 1) / N_STEPS;
+
+    //! finish the sort in one step, the next pass must then find nothing to swap
+    sorter.setMaxSwapsPerStep(N_COLLIDERS);
+    sorter.step(colony, [&](int id)
+                { return keyOf(colony, id); });
+    bool ok = sorter.step(colony, [&](int id)
+                          { return keyOf(colony, id); }) == 0;
+    for (std::size_t data_ind = 1; data_ind < colony.data.size(); ++data_ind)
+    {
+        ok &= utils::mortonCode(colony.data[data_ind - 1].pos, CELL_SIZE) <= utils::mortonCode(colony.data[data_ind].pos, CELL_SIZE);
+    }
+
+    float sorted_sum = 0.f;
+    auto sorted_ms = measureMs([&]
+                               { sorted_sum = narrowPhase(colony, pairs); });
+    ok &= sorted_sum == unsorted_sum;
+
+    std::printf("spatial sort: %d colliders, %zu close pairs, unsorted %.2f ms, Z-order %.2f ms, sorter step %.3f ms %s\n",
+                N_COLLIDERS, pairs.size(), unsorted_ms, sorted_ms, step_ms, ok ? "" : "MISMATCH");
+    return ok;
+}
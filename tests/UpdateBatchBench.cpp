@@ -0,0 +1,110 @@
+#include "Bench.h"
+
+#include <vector>
+#include <random>
+#include <cstdlib>
+
+#include "Entities/Factories.h"
+
+//! real entities of a few classes in a GameWorld, updated through GameObject::updateAll in creation order
+//! or grouped by type through GameObject::updateAllAs, the way GameWorld does it in UpdateMode::TypeBatched
+namespace
+{
+    //! the objects in creation order, the types are mixed
+    std::vector<GameObject *> makeEntities(GameWorld &world, int n_entities)
+    {
+        std::vector<GameObject *> entities;
+        std::srand(7); //! meteors draw their shape and motion from rand(), both worlds must get the same ones
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<int> type_dist(0, 2);
+        std::uniform_real_distribution<float> dist(-100.f, 100.f);
+        for (int i = 0; i < n_entities; ++i)
+        {
+            utils::Vector2f pos = {10.f * dist(gen), 10.f * dist(gen)};
+            utils::Vector2f vel = {dist(gen), dist(gen)};
+            switch (type_dist(gen))
+            {
+            case 0:
+            {
+                Meteor::Spec spec;
+                spec.pos = pos;
+                spec.vel = vel;
+                spec.size = {20.f, 20.f};
+                entities.push_back(&world.createObject(spec));
+                break;
+            }
+            case 1:
+            {
+                Bullet::Spec spec;
+                spec.obj_type = TypeId::Bullet;
+                spec.pos = pos;
+                spec.vel = vel;
+                spec.size = {5.f, 5.f};
+                entities.push_back(&world.createObject(spec));
+                break;
+            }
+            default:
+            {
+                Box::Spec spec;
+                spec.pos = pos;
+                spec.vel = vel;
+                spec.size = {10.f, 10.f};
+                entities.push_back(&world.createObject(spec));
+            }
+            }
+        }
+        world.update(0.f); //! the entities get into the world (and its type lists) at the end of the frame
+        return entities;
+    }
+
+    template <class EntityType>
+    void updateBatch(GameWorld &world, float dt)
+    {
+        world.forEachOfType<EntityType>([dt](EntityType &entity)
+                                        { entity.template updateAllAs<EntityType>(dt); });
+    }
+} //! namespace
+
+//! both ways must move the entities the same, only the order of the updates differs
+bool benchUpdateBatches()
+{
+    constexpr int N_ENTITIES = 5000;
+    constexpr int N_FRAMES = 200;
+    constexpr float DT = 1.f / 60.f;
+
+    PostOffice virtual_messenger;
+    GameWorld virtual_world(virtual_messenger);
+    auto virtual_entities = makeEntities(virtual_world, N_ENTITIES);
+    PostOffice batched_messenger;
+    GameWorld batched_world(batched_messenger);
+    auto batched_entities = makeEntities(batched_world, N_ENTITIES);
+
+    auto virtual_ms = measureMs([&]
+                                {
+        for (int frame = 0; frame < N_FRAMES; ++frame)
+        {
+            for (auto p_entity : virtual_entities)
+            {
+                p_entity->updateAll(DT);
+            }
+        } }, 1);
+    auto batched_ms = measureMs([&]
+                                {
+        for (int frame = 0; frame < N_FRAMES; ++frame)
+        {
+            updateBatch<Meteor>(batched_world, DT);
+            updateBatch<Bullet>(batched_world, DT);
+            updateBatch<Box>(batched_world, DT);
+        } }, 1);
+
+    bool ok = true;
+    for (std::size_t i = 0; i < virtual_entities.size(); ++i)
+    {
+        auto pos_a = virtual_entities[i]->getPosition();
+        auto pos_b = batched_entities[i]->getPosition();
+        ok &= pos_a.x == pos_b.x && pos_a.y == pos_b.y && virtual_entities[i]->getAngle() == batched_entities[i]->getAngle();
+    }
+    std::printf("update: %d entities x %d frames, updateAll %.2f ms, updateAllAs by type %.2f ms %s\n",
+                N_ENTITIES, N_FRAMES, virtual_ms, batched_ms, ok ? "" : "MISMATCH");
+    return ok;
+}
@@ -0,0 +1,17 @@
+#include "Bench.h"
+
+//! runs benchmarks and checks of the engine parts which do not draw anything
+int main()
+{
+    bool ok = true;
+    ok &= benchSparseIndex();
+    ok &= benchParallelForEach();
+    ok &= benchUpdateBatches();
+    ok &= benchCollisionKernel();
+    ok &= benchSnapshot();
+    ok &= benchSpatialSort();
+    ok &= checkDelayedComponents();
+
+    std::printf(ok ? "all checks passed\n" : "some checks FAILED\n");
+    return ok ? 0 : 1;
+}